@@ -11,6 +11,7 @@
 
 import QtQuick 2.1
 import Sailfish.Silica 1.0
+import Sailfish.WebView.Controls 1.0
 import QOfono 0.2
 
 MouseArea {
@@ -39,10 +40,27 @@ MouseArea {
 
     property bool _phoneNumberSelected
 
+    // Browser:SelectionMove throttling, at most one move is in flight and
+    // at most one is sent per frame. A newer move replaces the pending one.
+    property bool _moveInFlight
+    property bool _waitingForFrame
+    property string _pendingMoveMarker
+
     property alias startHandleMask: start.mask
     property alias endHandleMask: end.mask
 
     function selectionRangeUpdated(data) {
+        if (_moveInFlight) {
+            _moveInFlight = false
+            moveTimeout.stop()
+            if (_pendingMoveMarker !== "") {
+                // The reply is for a stale handle position, the pending
+                // move will bring a fresh one.
+                _sendPendingMove()
+                return
+            }
+        }
+
         var resolution = contentItem.resolution
         start.lineHeight = data.start.height * resolution
         end.lineHeight = data.end.height * resolution
@@ -53,11 +71,11 @@ MouseArea {
         // Don't update root state yet.
         var state = data.src
 
-        var visualViewport = data.visualViewport
+        // Updates fixedX and fixedY of the markers. While panning and
+        // zooming the geometry keeps the markers attached to the selection.
+        geometry.setSelectionRange(data)
 
         // Start marker
-        start.fixedX = (data.start.xPos - visualViewport.offsetLeft) * resolution - start.width
-        start.fixedY = (data.start.yPos - visualViewport.offsetTop) * resolution
         if (!selectionVisible) {
             start.x = start.fixedX
             start.y = start.fixedY
@@ -66,9 +84,6 @@ MouseArea {
         }
 
         // End marker
-        end.fixedX = (data.end.xPos - visualViewport.offsetLeft) * resolution
-        end.fixedY = (data.end.yPos - visualViewport.offsetTop) * resolution
-
         if (!selectionVisible) {
             end.x = end.fixedX
             end.y = end.fixedY
@@ -86,7 +101,7 @@ MouseArea {
             "origOffsetX": contentItem.scrollableOffset.x,
             "origOffsetY": contentItem.scrollableOffset.y,
             "origResolution": resolution,
-            "visualViewport": visualViewport
+            "visualViewport": data.visualViewport
         }
 
         _selectionData = data
@@ -131,6 +146,7 @@ MouseArea {
     function clearSelection() {
         selectionVisible = false
         _cssRange = null
+        geometry.clear()
         contentItem.sendAsyncMessage("Browser:SelectionClose",
                                  {
                                      "clearSelection": true
@@ -141,25 +157,38 @@ MouseArea {
     }
 
 
-    function getMarkerBaseMessage(markerTag) {
-        var resolution = contentItem.resolution
-        var offsetLeft = _cssRange.visualViewport.offsetLeft * resolution
-        var offsetTop = _cssRange.visualViewport.offsetTop * resolution
-        return {
-            change: markerTag,
-            start: {
-                xPos: (start.x + offsetLeft + start.width) / resolution,
-                yPos: (start.y + offsetTop)/ resolution
-            },
-            end: {
-                xPos: (end.x + offsetLeft) / resolution,
-                yPos: (end.y + offsetTop) / resolution
-            },
-            caret: {
-                xPos: 0,
-                yPos: 0
-            },
+    function requestMove(markerTag) {
+        _pendingMoveMarker = markerTag
+        _sendPendingMove()
+    }
+
+    function flushMove() {
+        _waitingForFrame = false
+        moveTimeout.stop()
+        _moveInFlight = false
+        if (_pendingMoveMarker !== "") {
+            _sendPendingMove()
+        }
+    }
+
+    function _sendPendingMove() {
+        if (_pendingMoveMarker === "" || _moveInFlight || _waitingForFrame || !_cssRange) {
+            return
         }
+
+        // The message is built from the handle positions at send time so
+        // skipped moves are not lost.
+        var markerMessage = getMarkerBaseMessage(_pendingMoveMarker)
+        _pendingMoveMarker = ""
+        _moveInFlight = true
+        _waitingForFrame = true
+        geometry.requestFrame()
+        moveTimeout.restart()
+        contentItem.sendAsyncMessage("Browser:SelectionMove", markerMessage)
+    }
+
+    function getMarkerBaseMessage(markerTag) {
+        return geometry.markerMessage(markerTag)
     }
 
     // Selection is copied upon state change.
@@ -179,6 +208,19 @@ MouseArea {
         isPhoneNumber = _canCall && _phoneNumberSelected
     }
 
+    TextSelectionGeometry {
+        id: geometry
+
+        contentItem: root.contentItem
+        startHandle: start
+        endHandle: end
+
+        onFrame: {
+            root._waitingForFrame = false
+            root._sendPendingMove()
+        }
+    }
+
     TextSelectionHandle {
         id: start
 
@@ -199,6 +241,17 @@ MouseArea {
         selectionController: root
     }
 
+    Timer {
+        id: moveTimeout
+
+        // Don't wait for a lost Content:SelectionRange reply forever.
+        interval: 250
+        onTriggered: {
+            root._moveInFlight = false
+            root._sendPendingMove()
+        }
+    }
+
     Notice {
         id: notification
 
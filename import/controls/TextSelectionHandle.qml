@@ -30,6 +30,8 @@ Image {
     // that Browser:SelectionMoveStart is sent out before Browser:SelectionMove
     property bool moving
     readonly property bool dragActive: mouseArea.drag.active
+    // TextSelectionGeometry doesn't move the handle while true
+    readonly property bool positionLocked: dragActive || showAnimation.running || targetPositionAnimation.running
 
     // We could use these to programmatically scroll the content.
     readonly property bool atXBeginning: x - Theme.horizontalPageMargin <= 0
@@ -54,6 +56,8 @@ Image {
                                          selectionController.getMarkerBaseMessage(markerTag))
             moving = true
         } else {
+            // Deliver the last position before ending the move.
+            selectionController.flushMove()
             contentItem.sendAsyncMessage("Browser:SelectionMoveEnd",
                                          selectionController.getMarkerBaseMessage(markerTag))
             moving = false
@@ -103,8 +107,7 @@ Image {
                 return
             }
 
-            var markerMessage = selectionController.getMarkerBaseMessage(markerTag)
-            contentItem.sendAsyncMessage("Browser:SelectionMove", markerMessage)
+            selectionController.requestMove(markerTag)
             previousX = targetX
             previousY = targetY
         }
@@ -19,13 +19,15 @@ LIBS += -L../../lib -lsailfishwebengine
 HEADERS += \
     permissionmanager.h \
     permissionmodel.h \
-    permissionfilterproxymodel.h
+    permissionfilterproxymodel.h \
+    textselectiongeometry.h
 
 SOURCES += \
     controlsplugin.cpp \
     permissionmanager.cpp \
     permissionmodel.cpp \
-    permissionfilterproxymodel.cpp
+    permissionfilterproxymodel.cpp \
+    textselectiongeometry.cpp
 
 OTHER_FILES += \
     qmldir \
@@ -40,6 +42,9 @@ target.path = $$TARGETPATH
 
 INSTALLS += target import translations_install engineering_english_install
 
+QMLCACHE_FILES = $$files(*.qml) $$files(*.js)
+include(../qmlcache.pri)
+
 # The module is verbose on stdout, hence the use of dedicated FD for output.
 #
 # HACK: pass -nocomposites to work around the issue with types leaked
@@ -14,13 +14,13 @@
 #include <QtCore/QFileInfo>
 #include <QtCore/QLocale>
 #include <QtCore/QString>
-#include <QtCore/QTranslator>
-#include <QCoreApplication>
 #include <qqml.h>
 
 #include "permissionmanager.h"
 #include "permissionmodel.h"
 #include "permissionfilterproxymodel.h"
+#include "textselectiongeometry.h"
+#include "translationregistry.h"
 
 template <typename T> static QObject *singletonApiFactory(QQmlEngine *engine, QJSEngine *)
 {
@@ -33,24 +33,6 @@ namespace WebView {
 
 namespace Controls {
 
-// using custom translator so it gets properly removed from qApp when engine is deleted
-class AppTranslator: public QTranslator
-{
-    Q_OBJECT
-
-public:
-    AppTranslator(QObject *parent)
-        : QTranslator(parent)
-    {
-        QCoreApplication::instance()->installTranslator(this);
-    }
-
-    virtual ~AppTranslator()
-    {
-        QCoreApplication::instance()->removeTranslator(this);
-    }
-};
-
 class SailfishOSWebViewTextSelectionPlugin : public QQmlExtensionPlugin
 {
     Q_OBJECT
@@ -64,16 +46,17 @@ public:
         qmlRegisterType<PermissionModel>("Sailfish.WebView.Controls", 1, 0, "PermissionModel");
         qmlRegisterType<PermissionFilterProxyModel>("Sailfish.WebView.Controls", 1, 0, "PermissionFilterProxyModel");
         qmlRegisterSingletonType<PermissionManager>("Sailfish.WebView.Controls", 1, 0, "PermissionManager", singletonApiFactory<PermissionManager>);
+        qmlRegisterType<TextSelectionGeometry>("Sailfish.WebView.Controls", 1, 0, "TextSelectionGeometry");
     }
 
     void initializeEngine(QQmlEngine *engine, const char *uri) override
     {
         Q_UNUSED(uri)
 
-        AppTranslator *engineeringEnglish = new AppTranslator(engine);
-        AppTranslator *translator = new AppTranslator(engine);
-        engineeringEnglish->load("sailfish_components_webview_controls_qt5_eng_en", "/usr/share/translations");
-        translator->load(QLocale(), "sailfish_components_webview_controls_qt5", "-", "/usr/share/translations");
+        // Loaded when the first text selection string is shown.
+        TranslationRegistry::instance()->addCatalog(
+                    engine, QStringLiteral("sailfish_components_webview_controls_qt5"),
+                    QStringList() << QStringLiteral("sailfish_components_webview_textselection-"));
     }
 };
 
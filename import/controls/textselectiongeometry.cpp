@@ -0,0 +1,245 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "textselectiongeometry.h"
+
+#include <QMetaMethod>
+#include <QMetaProperty>
+#include <QTimer>
+
+static QPointF cssPoint(const QVariant &value)
+{
+    const QVariantMap map = value.toMap();
+    return QPointF(map.value(QStringLiteral("xPos")).toReal(),
+                   map.value(QStringLiteral("yPos")).toReal());
+}
+
+static QVariantMap cssPosition(qreal x, qreal y)
+{
+    QVariantMap position;
+    position.insert(QStringLiteral("xPos"), x);
+    position.insert(QStringLiteral("yPos"), y);
+    return position;
+}
+
+TextSelectionGeometry::TextSelectionGeometry(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_hasSelection(false)
+    , m_frameRequested(false)
+{
+}
+
+QObject *TextSelectionGeometry::contentItem() const
+{
+    return m_contentItem;
+}
+
+void TextSelectionGeometry::setContentItem(QObject *contentItem)
+{
+    if (m_contentItem == contentItem) {
+        return;
+    }
+
+    if (m_contentItem) {
+        disconnect(m_contentItem, nullptr, this, nullptr);
+    }
+
+    m_contentItem = contentItem;
+
+    if (m_contentItem) {
+        // Resolved through the meta object so that any item providing
+        // QuickMozView's scrollableOffset and resolution properties works.
+        connectContentProperty("scrollableOffset");
+        connectContentProperty("resolution");
+    }
+
+    polish();
+    emit contentItemChanged();
+}
+
+QQuickItem *TextSelectionGeometry::startHandle() const
+{
+    return m_startHandle;
+}
+
+void TextSelectionGeometry::setStartHandle(QQuickItem *handle)
+{
+    if (m_startHandle != handle) {
+        m_startHandle = handle;
+        polish();
+        emit startHandleChanged();
+    }
+}
+
+QQuickItem *TextSelectionGeometry::endHandle() const
+{
+    return m_endHandle;
+}
+
+void TextSelectionGeometry::setEndHandle(QQuickItem *handle)
+{
+    if (m_endHandle != handle) {
+        m_endHandle = handle;
+        polish();
+        emit endHandleChanged();
+    }
+}
+
+bool TextSelectionGeometry::hasSelection() const
+{
+    return m_hasSelection;
+}
+
+void TextSelectionGeometry::setSelectionRange(const QVariantMap &data)
+{
+    m_start = cssPoint(data.value(QStringLiteral("start")));
+    m_end = cssPoint(data.value(QStringLiteral("end")));
+
+    const QVariantMap visualViewport = data.value(QStringLiteral("visualViewport")).toMap();
+    m_visualViewportOffset = QPointF(visualViewport.value(QStringLiteral("offsetLeft")).toReal(),
+                                     visualViewport.value(QStringLiteral("offsetTop")).toReal());
+    m_originScrollableOffset = scrollableOffset();
+
+    // The fixed positions are needed right away, the caller decides how
+    // handles are moved to them.
+    const QPointF offset = viewportOffset();
+    const qreal scale = resolution();
+    if (m_startHandle) {
+        m_startHandle->setProperty("fixedX", (m_start.x() - offset.x()) * scale - m_startHandle->width());
+        m_startHandle->setProperty("fixedY", (m_start.y() - offset.y()) * scale);
+    }
+    if (m_endHandle) {
+        m_endHandle->setProperty("fixedX", (m_end.x() - offset.x()) * scale);
+        m_endHandle->setProperty("fixedY", (m_end.y() - offset.y()) * scale);
+    }
+
+    if (!m_hasSelection) {
+        m_hasSelection = true;
+        emit hasSelectionChanged();
+    }
+}
+
+void TextSelectionGeometry::clear()
+{
+    if (m_hasSelection) {
+        m_hasSelection = false;
+        emit hasSelectionChanged();
+    }
+}
+
+QVariantMap TextSelectionGeometry::markerMessage(const QString &markerTag) const
+{
+    const QPointF offset = viewportOffset();
+    const qreal scale = resolution();
+
+    QVariantMap message;
+    message.insert(QStringLiteral("change"), markerTag);
+    if (m_startHandle) {
+        message.insert(QStringLiteral("start"),
+                       cssPosition((m_startHandle->x() + m_startHandle->width()) / scale + offset.x(),
+                                   m_startHandle->y() / scale + offset.y()));
+    }
+    if (m_endHandle) {
+        message.insert(QStringLiteral("end"),
+                       cssPosition(m_endHandle->x() / scale + offset.x(),
+                                   m_endHandle->y() / scale + offset.y()));
+    }
+    message.insert(QStringLiteral("caret"), cssPosition(0, 0));
+    return message;
+}
+
+void TextSelectionGeometry::updateHandlePositions()
+{
+    if (!m_hasSelection) {
+        return;
+    }
+
+    const QPointF offset = viewportOffset();
+    const qreal scale = resolution();
+    if (m_startHandle) {
+        positionHandle(m_startHandle, QPointF((m_start.x() - offset.x()) * scale - m_startHandle->width(),
+                                              (m_start.y() - offset.y()) * scale));
+    }
+    if (m_endHandle) {
+        positionHandle(m_endHandle, (m_end - offset) * scale);
+    }
+}
+
+void TextSelectionGeometry::requestFrame()
+{
+    if (m_frameRequested) {
+        return;
+    }
+
+    m_frameRequested = true;
+    if (window()) {
+        // Polishing schedules the next frame.
+        polish();
+    } else {
+        // Nothing is rendered, don't hold back the caller.
+        QTimer::singleShot(0, this, [this]() {
+            updatePolish();
+        });
+    }
+}
+
+void TextSelectionGeometry::updatePolish()
+{
+    updateHandlePositions();
+
+    if (m_frameRequested) {
+        m_frameRequested = false;
+        emit frame();
+    }
+}
+
+void TextSelectionGeometry::contentGeometryChanged()
+{
+    if (m_hasSelection) {
+        polish();
+    }
+}
+
+void TextSelectionGeometry::connectContentProperty(const char *name)
+{
+    const QMetaObject *metaObject = m_contentItem->metaObject();
+    const QMetaProperty property = metaObject->property(metaObject->indexOfProperty(name));
+    if (property.hasNotifySignal()) {
+        connect(m_contentItem, property.notifySignal(),
+                this, staticMetaObject.method(staticMetaObject.indexOfSlot("contentGeometryChanged()")));
+    }
+}
+
+void TextSelectionGeometry::positionHandle(QQuickItem *handle, const QPointF &position)
+{
+    handle->setProperty("fixedX", position.x());
+    handle->setProperty("fixedY", position.y());
+    if (!handle->property("positionLocked").toBool()) {
+        handle->setPosition(position);
+    }
+}
+
+// Offset of the visual viewport in CSS pixels, adjusted for panning
+// since the selection range was received.
+QPointF TextSelectionGeometry::viewportOffset() const
+{
+    return m_visualViewportOffset + scrollableOffset() - m_originScrollableOffset;
+}
+
+QPointF TextSelectionGeometry::scrollableOffset() const
+{
+    return m_contentItem ? m_contentItem->property("scrollableOffset").toPointF() : QPointF();
+}
+
+qreal TextSelectionGeometry::resolution() const
+{
+    const qreal resolution = m_contentItem ? m_contentItem->property("resolution").toReal() : 0.0;
+    return resolution > 0.0 ? resolution : 1.0;
+}
@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef TEXTSELECTIONGEOMETRY_H
+#define TEXTSELECTIONGEOMETRY_H
+
+#include <QPointer>
+#include <QQuickItem>
+#include <QVariantMap>
+
+/*
+ * Keeps the selection handles attached to the selected text while the
+ * content item (QuickMozView) pans and zooms. The selection range is kept
+ * in CSS pixels and mapped to item coordinates in updatePolish() using the
+ * current scrollableOffset and resolution of the content item, so no
+ * bindings need to be evaluated per frame.
+ *
+ * Handles are positioned unless their positionLocked property is true,
+ * e.g. while dragged or animated. Their fixedX and fixedY properties are
+ * always updated.
+ */
+class TextSelectionGeometry : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QObject *contentItem READ contentItem WRITE setContentItem NOTIFY contentItemChanged)
+    Q_PROPERTY(QQuickItem *startHandle READ startHandle WRITE setStartHandle NOTIFY startHandleChanged)
+    Q_PROPERTY(QQuickItem *endHandle READ endHandle WRITE setEndHandle NOTIFY endHandleChanged)
+    Q_PROPERTY(bool hasSelection READ hasSelection NOTIFY hasSelectionChanged)
+
+public:
+    TextSelectionGeometry(QQuickItem *parent = nullptr);
+
+    QObject *contentItem() const;
+    void setContentItem(QObject *contentItem);
+
+    QQuickItem *startHandle() const;
+    void setStartHandle(QQuickItem *handle);
+
+    QQuickItem *endHandle() const;
+    void setEndHandle(QQuickItem *handle);
+
+    bool hasSelection() const;
+
+    // Takes the Content:SelectionRange payload.
+    Q_INVOKABLE void setSelectionRange(const QVariantMap &data);
+    Q_INVOKABLE void clear();
+
+    // Base of the Browser:SelectionMove* messages for the current handle positions.
+    Q_INVOKABLE QVariantMap markerMessage(const QString &markerTag) const;
+
+    // Emits frame() once from the polish pass of the next frame, which runs
+    // on the GUI thread before the scene graph is synchronized.
+    Q_INVOKABLE void requestFrame();
+
+    void updateHandlePositions();
+
+signals:
+    void contentItemChanged();
+    void startHandleChanged();
+    void endHandleChanged();
+    void hasSelectionChanged();
+    void frame();
+
+protected:
+    void updatePolish() override;
+
+private slots:
+    void contentGeometryChanged();
+
+private:
+    void connectContentProperty(const char *name);
+    void positionHandle(QQuickItem *handle, const QPointF &position);
+    QPointF viewportOffset() const;
+    QPointF scrollableOffset() const;
+    qreal resolution() const;
+
+    QPointer<QObject> m_contentItem;
+    QPointer<QQuickItem> m_startHandle;
+    QPointer<QQuickItem> m_endHandle;
+    // In CSS pixels
+    QPointF m_start;
+    QPointF m_end;
+    QPointF m_visualViewportOffset;
+    QPointF m_originScrollableOffset;
+    bool m_hasSelection;
+    bool m_frameRequested;
+};
+
+#endif // TEXTSELECTIONGEOMETRY_H
@@ -4,3 +4,4 @@ SUBDIRS+=webengine webview pickers popups controls
 webview.depends = webengine
 pickers.depends = webview
 popups.depends = webview
+OTHER_FILES += qmlcache.pri
@@ -11,6 +11,7 @@
 
 import QtQuick 2.0
 import Sailfish.Silica 1.0
+import Sailfish.WebView.Pickers 1.0
 
 Dialog {
     id: selectDialog
@@ -19,34 +20,23 @@ Dialog {
     property var options
     property QtObject contentItem
 
-    onOpened: {
-        for (var i=0; i < options.length; i++) {
-            selectModel.append(options[i])
-        }
-    }
+    // Long lists get a search field
+    readonly property bool _searchable: selectModel.optionCount > 20
+
+    onOpened: selectModel.options = options
 
     onAccepted: {
-        var result = []
-        var item
-
-        for (var i = 0; i < selectModel.count; i++) {
-            item = selectModel.get(i)
-            result.push({
-                "selected": item.selected,
-                "index": item.index
-            })
-        }
-        contentItem.sendAsyncMessage("embedui:selectresponse", {"result": result})
+        contentItem.sendAsyncMessage("embedui:selectresponse", {"result": selectModel.result()})
     }
 
     onRejected: {
         contentItem.sendAsyncMessage("embedui:selectresponse", {"result": -1})
     }
 
-    ListModel {
+    SelectModel {
         id: selectModel
 
-        property int selectedIndex: -1
+        multiple: true
     }
 
     SilicaListView {
@@ -55,11 +45,22 @@ Dialog {
         anchors.fill: parent
         model: selectModel
 
-        header: DialogHeader {
-            dialog: selectDialog
-            //% "Select"
-            acceptText: qsTrId("sailfish_components_webview_pickers-he-select")
-            _glassOnly: true
+        header: Column {
+            width: listView.width
+
+            DialogHeader {
+                dialog: selectDialog
+                //% "Select"
+                acceptText: qsTrId("sailfish_components_webview_pickers-he-select")
+                _glassOnly: true
+            }
+
+            SearchField {
+                width: parent.width
+                visible: selectDialog._searchable
+                inputMethodHints: Qt.ImhNoAutoUppercase | Qt.ImhNoPredictiveText
+                onTextChanged: selectModel.filter = text
+            }
         }
 
         section {
@@ -72,7 +73,7 @@ Dialog {
         delegate: BackgroundItem {
             enabled: !disabled
 
-            onClicked: selectModel.setProperty(index, "selected", !selected)
+            onClicked: selectModel.toggle(index)
 
             Label {
                 x: Theme.paddingLarge
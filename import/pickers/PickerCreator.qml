@@ -11,6 +11,7 @@
 
 import QtQuick 2.1
 import Sailfish.Pickers 1.0
+import Sailfish.WebView.Pickers 1.0
 
 Item {
     id: pickerCreator
@@ -20,47 +21,55 @@ Item {
     property string mimeType
     property int mode
     property Item pageStack
+    // Gecko accepts opened file descriptors with the files
+    property alias fileDescriptors: fileHandoff.fileDescriptors
 
     readonly property int _nsIFilePicker_modeOpen: 0
     readonly property int _nsIFilePicker_modeOpenMultiple: 3
 
     function sendResponse(selectedContent) {
-        var scheme = "file://"
-        var filePath = selectedContent.toString()
+        var file = selectedContent.toString()
+        _prepare(file ? [file] : [])
+    }
 
-        if (filePath.indexOf(scheme) === 0) {
-            filePath = filePath.slice(scheme.length, filePath.length)
+    function sendResponseList(selectedContent) {
+        var files = []
+        for (var i = 0; selectedContent && i < selectedContent.count; i++) {
+            files.push(selectedContent.get(i).filePath)
         }
+        _prepare(files)
+    }
 
-        contentItem.sendAsyncMessage("filepickerresponse",
-                                 {
-                                     "winId": winId,
-                                     "accepted": filePath ? true : false,
-                                     "items": [filePath]
-                                 })
-        pickerCreator.destroy()
+    function _prepare(files) {
+        if (files.length > 0) {
+            fileHandoff.prepare(files)
+        } else {
+            _send([])
+        }
     }
 
-    function sendResponseList(selectedContent) {
-        var scheme = "file://"
-        var result = []
-        for (var i = 0; selectedContent && i < selectedContent.count; i++) {
-            var filePath = selectedContent.get(i).filePath
-            if (filePath.indexOf(scheme) === 0) {
-                filePath = filePath.slice(scheme.length, filePath.length)
-            }
-            result.push(filePath)
+    function _send(files) {
+        var items = []
+        for (var i = 0; i < files.length; i++) {
+            items.push(files[i].path)
         }
 
         contentItem.sendAsyncMessage("filepickerresponse",
                                  {
                                      "winId": winId,
-                                     "accepted": result.length > 0,
-                                     "items": result
+                                     "accepted": items.length > 0,
+                                     "items": items,
+                                     "files": files
                                  })
         pickerCreator.destroy()
     }
 
+    FileHandoff {
+        id: fileHandoff
+
+        onFinished: pickerCreator._send(files)
+    }
+
     Component.onCompleted: {
         if (mode == _nsIFilePicker_modeOpenMultiple) {
             switch (mimeType) {
@@ -12,15 +12,12 @@
 
 import QtQuick 2.2
 import Sailfish.WebEngine 1.0
+import "PickerTopics.js" as PickerTopics
 
 QtObject {
     property var pageStack
     property QtObject contentItem
-    readonly property var listeners: [ "embed:colorpicker",
-                                       "embed:filepicker",
-                                       "embed:selectasync",
-                                       "embedui:downloadpicker",
-                                       "embed:downloadpicker" ]
+    readonly property var listeners: PickerTopics.listeners
 
     // Defer compilation of picker components
     readonly property string _multiSelectComponentUrl: Qt.resolvedUrl("MultiSelectDialog.qml")
@@ -72,7 +69,8 @@ QtObject {
                                                       "winId": winId,
                                                       "contentItem": contentItem,
                                                       "mimeType": data.mimeType,
-                                                      "mode": data.mode})
+                                                      "mode": data.mode,
+                                                      "fileDescriptors": data.fileDescriptors === true})
             } else if (_filePickerComponent.status === Component.Error) {
                 // Component development time issue, component creation should newer fail.
                 console.warn("PickerOpener failed to create PickerOpener: ", _filePickerComponent.errorString())
@@ -94,8 +92,12 @@ QtObject {
 
     Component.onCompleted: {
         if (contentItem) {
-            for (var i = 0; i < listeners.length; ++i) {
-                contentItem.addMessageListener(listeners[i])
+            if (contentItem.addMessageListeners) {
+                contentItem.addMessageListeners(listeners)
+            } else {
+                for (var i = 0; i < listeners.length; ++i) {
+                    contentItem.addMessageListener(listeners[i])
+                }
             }
         } else {
             console.log("PickerOpener has no contentItem. Each created WebView/WebPage",
@@ -0,0 +1,19 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+.pragma library
+
+// Message topics handled by PickerOpener, shared by all views so that they
+// can be registered before a PickerOpener is created.
+var listeners = [ "embed:colorpicker",
+                  "embed:filepicker",
+                  "embed:selectasync",
+                  "embedui:downloadpicker",
+                  "embed:downloadpicker" ]
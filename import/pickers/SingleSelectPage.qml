@@ -11,6 +11,7 @@
 
 import QtQuick 2.0
 import Sailfish.Silica 1.0
+import Sailfish.WebView.Pickers 1.0
 
 Page {
     id: selectPage
@@ -19,27 +20,18 @@ Page {
     property var options
     property QtObject contentItem
 
+    // Long lists get a search field
+    readonly property bool _searchable: selectModel.optionCount > 20
+
     Component.onCompleted: {
-        for (var i=0; i < options.length; i++) {
-            selectModel.append(options[i])
-            if (options[i]["selected"]) {
-                selectModel.selectedIndex = options[i]["index"]
-            }
+        selectModel.options = options
+        if (selectModel.selectedRow >= 0) {
+            listView.positionViewAtIndex(selectModel.selectedRow, ListView.Center)
         }
     }
 
     function selected() {
-        var result = []
-        var item
-
-        for (var i = 0; i < selectModel.count; i++) {
-            item = selectModel.get(i)
-            result.push({
-                "selected": item.selected,
-                "index": item.index
-            })
-        }
-        contentItem.sendAsyncMessage("embedui:selectresponse", {"result": result})
+        contentItem.sendAsyncMessage("embedui:selectresponse", {"result": selectModel.result()})
         pageStack.pop()
     }
 
@@ -50,10 +42,8 @@ Page {
         }
     }
 
-    ListModel {
+    SelectModel {
         id: selectModel
-
-        property int selectedIndex: -1
     }
 
     SilicaListView {
@@ -61,10 +51,22 @@ Page {
 
         anchors.fill: parent
         model: selectModel
+        currentIndex: -1
+
+        header: Column {
+            width: listView.width
 
-        header: PageHeader {
-            //% "Select"
-            title: qsTrId("sailfish_components_webview_pickers-he-select")
+            PageHeader {
+                //% "Select"
+                title: qsTrId("sailfish_components_webview_pickers-he-select")
+            }
+
+            SearchField {
+                width: parent.width
+                visible: selectPage._searchable
+                inputMethodHints: Qt.ImhNoAutoUppercase | Qt.ImhNoPredictiveText
+                onTextChanged: selectModel.filter = text
+            }
         }
 
         section {
@@ -80,11 +82,7 @@ Page {
             enabled: !disabled
 
             onClicked: {
-                if (selectModel.selectedIndex !== index) {
-                    selectModel.setProperty(index, "selected", true)
-                    selectModel.setProperty(selectModel.selectedIndex, "selected", false)
-                    selectModel.selectedIndex = index
-                }
+                selectModel.select(index)
                 selectPage.selected()
             }
 
@@ -0,0 +1,203 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "filehandoff.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMimeDatabase>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtCore/QUrl>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace SailfishOS {
+
+namespace WebView {
+
+namespace Pickers {
+
+namespace {
+
+class HandoffRunnable : public QRunnable
+{
+public:
+    HandoffRunnable(const std::shared_ptr<FileHandoff::Job> &job)
+        : m_job(job)
+    {
+    }
+
+    void run() override
+    {
+        for (const QString &file : m_job->files) {
+            const QVariantMap prepared = FileHandoff::prepareFile(file, m_job->fileDescriptors);
+            if (!prepared.isEmpty()) {
+                m_job->result.append(prepared);
+            }
+        }
+
+        QMutexLocker locker(&m_job->mutex);
+        m_job->done = true;
+        if (m_job->receiver) {
+            QMetaObject::invokeMethod(m_job->receiver, "jobFinished", Qt::QueuedConnection,
+                                      Q_ARG(uint, m_job->generation));
+        } else {
+            // Nobody takes the descriptors.
+            FileHandoff::closeFileDescriptors(m_job->result);
+        }
+    }
+
+private:
+    std::shared_ptr<FileHandoff::Job> m_job;
+};
+
+}
+
+FileHandoff::FileHandoff(QObject *parent)
+    : QObject(parent)
+    , m_fileDescriptors(false)
+    , m_generation(0)
+{
+}
+
+FileHandoff::~FileHandoff()
+{
+    detachJob();
+}
+
+bool FileHandoff::fileDescriptors() const
+{
+    return m_fileDescriptors;
+}
+
+void FileHandoff::setFileDescriptors(bool fileDescriptors)
+{
+    if (m_fileDescriptors != fileDescriptors) {
+        m_fileDescriptors = fileDescriptors;
+        emit fileDescriptorsChanged();
+    }
+}
+
+bool FileHandoff::busy() const
+{
+    return m_job != nullptr;
+}
+
+void FileHandoff::prepare(const QStringList &files)
+{
+    const bool wasBusy = busy();
+    detachJob();
+
+    std::shared_ptr<Job> job(new Job);
+    job->generation = ++m_generation;
+    job->files = files;
+    job->fileDescriptors = m_fileDescriptors;
+    job->receiver = this;
+    m_job = job;
+    QThreadPool::globalInstance()->start(new HandoffRunnable(job));
+
+    if (!wasBusy) {
+        emit busyChanged();
+    }
+}
+
+QVariantMap FileHandoff::prepareFile(const QString &file, bool fileDescriptor)
+{
+    const QString path = file.startsWith(QLatin1String("file://")) ? QUrl(file).toLocalFile() : file;
+    if (path.isEmpty()) {
+        return QVariantMap();
+    }
+
+    // One open and fstat instead of separate checks on the path.
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return QVariantMap();
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0 || !S_ISREG(status.st_mode)) {
+        ::close(fd);
+        return QVariantMap();
+    }
+
+    // The extension is enough for most picked files, the content is only
+    // read when it isn't.
+    static const QMimeDatabase mimeDatabase;
+    QMimeType mimeType = mimeDatabase.mimeTypeForFile(path, QMimeDatabase::MatchExtension);
+    if (mimeType.isDefault()) {
+        QFile content;
+        if (content.open(fd, QIODevice::ReadOnly, QFileDevice::DontCloseHandle)) {
+            mimeType = mimeDatabase.mimeTypeForData(&content);
+            content.close();
+        }
+        ::lseek(fd, 0, SEEK_SET);
+    }
+
+    QVariantMap prepared;
+    prepared.insert(QStringLiteral("path"), path);
+    prepared.insert(QStringLiteral("name"), QFileInfo(path).fileName());
+    prepared.insert(QStringLiteral("size"), static_cast<qint64>(status.st_size));
+    prepared.insert(QStringLiteral("mimeType"), mimeType.name());
+    prepared.insert(QStringLiteral("lastModified"), static_cast<qint64>(status.st_mtime) * 1000);
+
+    if (fileDescriptor) {
+        prepared.insert(QStringLiteral("fd"), fd);
+    } else {
+        ::close(fd);
+    }
+
+    return prepared;
+}
+
+void FileHandoff::closeFileDescriptors(const QVariantList &files)
+{
+    for (const QVariant &file : files) {
+        const QVariantMap map = file.toMap();
+        if (map.contains(QStringLiteral("fd"))) {
+            ::close(map.value(QStringLiteral("fd")).toInt());
+        }
+    }
+}
+
+void FileHandoff::jobFinished(uint generation)
+{
+    if (!m_job || m_job->generation != generation) {
+        // Replaced, detachJob() took care of it.
+        return;
+    }
+
+    const std::shared_ptr<Job> job = m_job;
+    m_job.reset();
+    emit busyChanged();
+    emit finished(job->result);
+}
+
+void FileHandoff::detachJob()
+{
+    if (m_job) {
+        QMutexLocker locker(&m_job->mutex);
+        m_job->receiver = nullptr;
+        if (m_job->done) {
+            // Finished but not delivered.
+            closeFileDescriptors(m_job->result);
+        }
+    }
+    m_job.reset();
+}
+
+} // namespace Pickers
+
+} // namespace WebView
+
+} // namespace SailfishOS
@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_WEBVIEW_PICKERS_FILEHANDOFF_H
+#define SAILFISHOS_WEBVIEW_PICKERS_FILEHANDOFF_H
+
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+
+#include <memory>
+
+namespace SailfishOS {
+
+namespace WebView {
+
+namespace Pickers {
+
+// Prepares picked files for upload. The files are opened and validated in
+// the thread pool and the result is a list of files with their path,
+// name, size, mimeType and lastModified time (ms since epoch).
+//
+// When fileDescriptors is set, each file also has the fd it was opened
+// with. The receiver of the result owns the descriptors and must close
+// them, Gecko does so for the filepickerresponse it accepts them in.
+class FileHandoff : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool fileDescriptors READ fileDescriptors WRITE setFileDescriptors NOTIFY fileDescriptorsChanged)
+    Q_PROPERTY(bool busy READ busy NOTIFY busyChanged)
+
+public:
+    explicit FileHandoff(QObject *parent = nullptr);
+    ~FileHandoff();
+
+    bool fileDescriptors() const;
+    void setFileDescriptors(bool fileDescriptors);
+
+    bool busy() const;
+
+    // Accepts paths and file urls. Emits finished once the files are
+    // prepared, files that can not be read are left out.
+    Q_INVOKABLE void prepare(const QStringList &files);
+
+    // Opens and validates a file, returns an empty map if it can't be
+    // uploaded.
+    static QVariantMap prepareFile(const QString &file, bool fileDescriptor);
+    static void closeFileDescriptors(const QVariantList &files);
+
+    struct Job
+    {
+        uint generation;
+        QStringList files;
+        bool fileDescriptors;
+        QVariantList result;
+
+        QMutex mutex;
+        QObject *receiver = nullptr;
+        bool done = false;
+    };
+
+signals:
+    void fileDescriptorsChanged();
+    void busyChanged();
+    void finished(const QVariantList &files);
+
+private slots:
+    void jobFinished(uint generation);
+
+private:
+    void detachJob();
+
+    bool m_fileDescriptors;
+    uint m_generation;
+    std::shared_ptr<Job> m_job;
+};
+
+} // namespace Pickers
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#endif // SAILFISHOS_WEBVIEW_PICKERS_FILEHANDOFF_H
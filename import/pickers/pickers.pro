@@ -13,18 +13,28 @@ QT += qml quick
 
 QMAKE_CXXFLAGS += -fPIC
 
-HEADERS += pickersplugin.h
-SOURCES += pickersplugin.cpp
-OTHER_FILES += qmldir plugins.qmltypes *qml
+INCLUDEPATH += ../../lib
+LIBS += -L../../lib -lsailfishwebengine
+
+HEADERS += filehandoff.h \
+           pickersplugin.h \
+           selectmodel.h
+SOURCES += filehandoff.cpp \
+           pickersplugin.cpp \
+           selectmodel.cpp
+OTHER_FILES += qmldir plugins.qmltypes *qml *.js
 
 include(pickerstranslations.pri)
 
-import.files = qmldir plugins.qmltypes *.qml
+import.files = qmldir plugins.qmltypes *.qml *.js
 import.path = $$TARGETPATH
 target.path = $$TARGETPATH
 
 INSTALLS += target import translations_install engineering_english_install
 
+QMLCACHE_FILES = $$files(*.qml) $$files(*.js)
+include(../qmlcache.pri)
+
 # The module is verbose on stdout, hence the use of dedicated FD for output.
 #
 # HACK: pass -nocomposites to work around the issue with types leaked
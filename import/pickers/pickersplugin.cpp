@@ -10,6 +10,9 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "pickersplugin.h"
+#include "filehandoff.h"
+#include "selectmodel.h"
+#include "translationregistry.h"
 
 #include <QtQml/QQmlEngine>
 #include <QtQml/QQmlContext>
@@ -20,18 +23,27 @@ namespace WebView {
 
 namespace Pickers {
 
-void SailfishOSWebViewPickersPlugin::registerTypes(const char *)
+void SailfishOSWebViewPickersPlugin::registerTypes(const char *uri)
 {
+    Q_ASSERT(uri == QLatin1String("Sailfish.WebView.Pickers"));
+    qmlRegisterType<FileHandoff>("Sailfish.WebView.Pickers", 1, 0, "FileHandoff");
+    qmlRegisterType<SelectModel>("Sailfish.WebView.Pickers", 1, 0, "SelectModel");
 }
 
 void SailfishOSWebViewPickersPlugin::initializeEngine(QQmlEngine *engine, const char *uri)
 {
     Q_ASSERT(uri == QLatin1String("Sailfish.WebView.Pickers"));
 
-    AppTranslator *engineeringEnglish = new AppTranslator(engine);
-    AppTranslator *translator = new AppTranslator(engine);
-    engineeringEnglish->load("sailfish_components_webview_pickers_qt5_eng_en", "/usr/share/translations");
-    translator->load(QLocale(), "sailfish_components_webview_pickers_qt5", "-", "/usr/share/translations");
+    // Loaded when the first picker is opened.
+    TranslationRegistry::instance()->addCatalog(
+                engine, QStringLiteral("sailfish_components_webview_pickers_qt5"),
+                QStringList() << QStringLiteral("sailfish_components_webview_pickers-"));
+
+    // Shared with the browser, a prefix would load the catalog for every
+    // string of the browser.
+    TranslationRegistry::instance()->addCatalogIds(
+                QStringLiteral("sailfish_components_webview_pickers_qt5"),
+                QStringList() << QStringLiteral("sailfish_browser-ti-download-to"));
 }
 
 } // namespace Pickers
@@ -15,7 +15,6 @@
 #include <QtQml/QQmlExtensionPlugin>
 #include <QtQuick/QQuickItem>
 
-#include <QtCore/QTranslator>
 #include <QtCore/QLocale>
 
 namespace SailfishOS {
@@ -34,24 +33,6 @@ public:
     void initializeEngine(QQmlEngine *engine, const char *uri);
 };
 
-// using custom translator so it gets properly removed from qApp when engine is deleted
-class AppTranslator: public QTranslator
-{
-    Q_OBJECT
-
-public:
-    AppTranslator(QObject *parent)
-        : QTranslator(parent)
-    {
-        qApp->installTranslator(this);
-    }
-
-    virtual ~AppTranslator()
-    {
-        qApp->removeTranslator(this);
-    }
-};
-
 } // namespace Pickers
 
 } // namespace WebView
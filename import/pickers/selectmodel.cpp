@@ -0,0 +1,388 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "selectmodel.h"
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+
+namespace SailfishOS {
+
+namespace WebView {
+
+namespace Pickers {
+
+namespace {
+
+class FilterRunnable : public QRunnable
+{
+public:
+    FilterRunnable(const std::shared_ptr<SelectModel::FilterJob> &job)
+        : m_job(job)
+    {
+    }
+
+    void run() override
+    {
+        SelectModel::runFilter(m_job.get());
+
+        // The model detaches the job when it is replaced or destroyed.
+        QMutexLocker locker(&m_job->mutex);
+        if (m_job->receiver) {
+            QMetaObject::invokeMethod(m_job->receiver, "filterFinished", Qt::QueuedConnection,
+                                      Q_ARG(uint, m_job->generation));
+        }
+    }
+
+private:
+    std::shared_ptr<SelectModel::FilterJob> m_job;
+};
+
+}
+
+SelectModel::SelectModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_multiple(false)
+    , m_filterGeneration(0)
+{
+}
+
+SelectModel::~SelectModel()
+{
+    detachFilterJob();
+}
+
+QVariant SelectModel::data(const QModelIndex &index, int role) const
+{
+    const int row = index.row();
+    if (row < 0 || row >= m_rows.count()) {
+        return QVariant();
+    }
+
+    const int option = m_rows.at(row);
+    const Option &item = m_optionList.at(option);
+    switch (role) {
+    case Label:
+        return m_labels.at(option);
+    case Group:
+        return item.group;
+    case OptionIndex:
+        return item.index;
+    case Selected:
+        return item.selected;
+    case Disabled:
+        return item.disabled;
+    default:
+        return QVariant();
+    }
+}
+
+int SelectModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return m_rows.count();
+}
+
+QHash<int, QByteArray> SelectModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[Label] = "label";
+    roles[Group] = "group";
+    roles[OptionIndex] = "optionIndex";
+    roles[Selected] = "selected";
+    roles[Disabled] = "disabled";
+    return roles;
+}
+
+QVariant SelectModel::options() const
+{
+    return m_options;
+}
+
+void SelectModel::setOptions(const QVariant &options)
+{
+    // A JS array from QML, convert it to a list.
+    const QVariantList list = options.value<QVariantList>();
+
+    const QString labelKey(QStringLiteral("label"));
+    const QString groupKey(QStringLiteral("group"));
+    const QString indexKey(QStringLiteral("index"));
+    const QString selectedKey(QStringLiteral("selected"));
+    const QString disabledKey(QStringLiteral("disabled"));
+
+    QVector<Option> optionList;
+    QVector<QString> labels;
+    optionList.reserve(list.count());
+    labels.reserve(list.count());
+    for (const QVariant &value : list) {
+        const QVariantMap map = value.toMap();
+        Option option;
+        option.group = map.value(groupKey).toString();
+        option.index = map.value(indexKey, optionList.count()).toInt();
+        option.selected = map.value(selectedKey).toBool();
+        option.initiallySelected = option.selected;
+        option.disabled = map.value(disabledKey).toBool();
+        optionList.append(option);
+        labels.append(map.value(labelKey).toString());
+    }
+
+    QVector<int> rows(optionList.count());
+    for (int i = 0; i < rows.count(); ++i) {
+        rows[i] = i;
+    }
+
+    const int oldCount = m_rows.count();
+    const bool wasFiltering = filtering();
+    beginResetModel();
+    m_options = options;
+    m_optionList = optionList;
+    m_labels = labels;
+    m_rows = rows;
+    m_appliedFilter.clear();
+    detachFilterJob();
+    ++m_filterGeneration;
+    endResetModel();
+
+    emit optionsChanged();
+    emit selectionChanged();
+    if (oldCount != m_rows.count()) {
+        emit countChanged();
+    }
+    if (wasFiltering) {
+        emit filteringChanged();
+    }
+
+    if (!m_filter.isEmpty()) {
+        const QString filter = m_filter;
+        m_filter.clear();
+        setFilter(filter);
+    }
+}
+
+bool SelectModel::multiple() const
+{
+    return m_multiple;
+}
+
+void SelectModel::setMultiple(bool multiple)
+{
+    if (m_multiple != multiple) {
+        m_multiple = multiple;
+        emit multipleChanged();
+    }
+}
+
+QString SelectModel::filter() const
+{
+    return m_filter;
+}
+
+void SelectModel::setFilter(const QString &filter)
+{
+    if (m_filter == filter) {
+        return;
+    }
+
+    const bool wasFiltering = filtering();
+    m_filter = filter;
+    emit filterChanged();
+
+    detachFilterJob();
+
+    std::shared_ptr<FilterJob> job(new FilterJob);
+    job->generation = ++m_filterGeneration;
+    job->filter = filter;
+    job->labels = m_labels;
+    // Typing more only narrows the current rows down.
+    job->allOptions = m_appliedFilter.isEmpty() || !filter.contains(m_appliedFilter, Qt::CaseInsensitive);
+    if (!job->allOptions) {
+        job->candidates = m_rows;
+    }
+
+    if (m_optionList.count() < AsyncFilterThreshold) {
+        runFilter(job.get());
+        m_appliedFilter = filter;
+        setRows(job->rows);
+    } else {
+        job->receiver = this;
+        m_filterJob = job;
+        QThreadPool::globalInstance()->start(new FilterRunnable(job));
+    }
+
+    if (wasFiltering != filtering()) {
+        emit filteringChanged();
+    }
+}
+
+bool SelectModel::filtering() const
+{
+    return m_filterJob != nullptr;
+}
+
+int SelectModel::optionCount() const
+{
+    return m_optionList.count();
+}
+
+int SelectModel::selectedRow() const
+{
+    for (int row = 0; row < m_rows.count(); ++row) {
+        if (m_optionList.at(m_rows.at(row)).selected) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+void SelectModel::select(int row)
+{
+    if (row < 0 || row >= m_rows.count()) {
+        return;
+    }
+
+    const int option = m_rows.at(row);
+    if (!m_multiple) {
+        for (int i = 0; i < m_optionList.count(); ++i) {
+            if (i != option && m_optionList.at(i).selected) {
+                setSelected(i, false);
+            }
+        }
+    }
+    setSelected(option, true);
+}
+
+void SelectModel::toggle(int row)
+{
+    if (row < 0 || row >= m_rows.count()) {
+        return;
+    }
+
+    const int option = m_rows.at(row);
+    if (m_optionList.at(option).selected) {
+        setSelected(option, false);
+    } else {
+        select(row);
+    }
+}
+
+QList<int> SelectModel::selectedIndexes() const
+{
+    QList<int> indexes;
+    for (const Option &option : m_optionList) {
+        if (option.selected) {
+            indexes.append(option.index);
+        }
+    }
+    return indexes;
+}
+
+QVariantList SelectModel::result() const
+{
+    const QString selectedKey(QStringLiteral("selected"));
+    const QString indexKey(QStringLiteral("index"));
+
+    QVariantList result;
+    for (const Option &option : m_optionList) {
+        if (option.selected != option.initiallySelected) {
+            QVariantMap item;
+            item.insert(selectedKey, option.selected);
+            item.insert(indexKey, option.index);
+            result.append(item);
+        }
+    }
+    return result;
+}
+
+void SelectModel::filterFinished(uint generation)
+{
+    if (!m_filterJob || m_filterJob->generation != generation) {
+        // Replaced by a later filter.
+        return;
+    }
+
+    const std::shared_ptr<FilterJob> job = m_filterJob;
+    m_filterJob.reset();
+    m_appliedFilter = job->filter;
+    setRows(job->rows);
+    emit filteringChanged();
+}
+
+void SelectModel::runFilter(FilterJob *job)
+{
+    if (job->filter.isEmpty()) {
+        job->rows.resize(job->labels.count());
+        for (int i = 0; i < job->rows.count(); ++i) {
+            job->rows[i] = i;
+        }
+        return;
+    }
+
+    if (job->allOptions) {
+        for (int i = 0; i < job->labels.count(); ++i) {
+            if (job->labels.at(i).contains(job->filter, Qt::CaseInsensitive)) {
+                job->rows.append(i);
+            }
+        }
+    } else {
+        for (int option : job->candidates) {
+            if (job->labels.at(option).contains(job->filter, Qt::CaseInsensitive)) {
+                job->rows.append(option);
+            }
+        }
+    }
+}
+
+void SelectModel::detachFilterJob()
+{
+    if (m_filterJob) {
+        QMutexLocker locker(&m_filterJob->mutex);
+        m_filterJob->receiver = nullptr;
+    }
+    m_filterJob.reset();
+}
+
+void SelectModel::setSelected(int option, bool selected)
+{
+    if (m_optionList.at(option).selected == selected) {
+        return;
+    }
+
+    m_optionList[option].selected = selected;
+    const int row = m_rows.indexOf(option);
+    if (row >= 0) {
+        const QModelIndex modelIndex = index(row);
+        emit dataChanged(modelIndex, modelIndex, QVector<int>() << Selected);
+    }
+    emit selectionChanged();
+}
+
+void SelectModel::setRows(const QVector<int> &rows)
+{
+    if (m_rows == rows) {
+        return;
+    }
+
+    const int oldCount = m_rows.count();
+    beginResetModel();
+    m_rows = rows;
+    endResetModel();
+
+    if (oldCount != m_rows.count()) {
+        emit countChanged();
+    }
+    emit selectionChanged();
+}
+
+} // namespace Pickers
+
+} // namespace WebView
+
+} // namespace SailfishOS
@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_WEBVIEW_PICKERS_SELECTMODEL_H
+#define SAILFISHOS_WEBVIEW_PICKERS_SELECTMODEL_H
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+#include <memory>
+
+namespace SailfishOS {
+
+namespace WebView {
+
+namespace Pickers {
+
+// Options of a <select> element. The options of the embed:select payload
+// are parsed once, rows are the options matching the filter.
+class SelectModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariant options READ options WRITE setOptions NOTIFY optionsChanged)
+    Q_PROPERTY(bool multiple READ multiple WRITE setMultiple NOTIFY multipleChanged)
+    Q_PROPERTY(QString filter READ filter WRITE setFilter NOTIFY filterChanged)
+    Q_PROPERTY(bool filtering READ filtering NOTIFY filteringChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int optionCount READ optionCount NOTIFY optionsChanged)
+    Q_PROPERTY(int selectedRow READ selectedRow NOTIFY selectionChanged)
+
+public:
+    enum Roles {
+        Label = Qt::UserRole,
+        Group,
+        OptionIndex,
+        Selected,
+        Disabled
+    };
+
+    explicit SelectModel(QObject *parent = nullptr);
+    ~SelectModel();
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QVariant options() const;
+    void setOptions(const QVariant &options);
+
+    bool multiple() const;
+    void setMultiple(bool multiple);
+
+    QString filter() const;
+    void setFilter(const QString &filter);
+
+    bool filtering() const;
+    int optionCount() const;
+    int selectedRow() const;
+
+    // Selects the option of row, in a single selection the others are
+    // deselected.
+    Q_INVOKABLE void select(int row);
+    Q_INVOKABLE void toggle(int row);
+
+    // Option indexes of the selected options.
+    Q_INVOKABLE QList<int> selectedIndexes() const;
+    // The embedui:selectresponse result, only the options whose selection
+    // changed.
+    Q_INVOKABLE QVariantList result() const;
+
+    // Options at or above this are filtered in a worker thread.
+    static const int AsyncFilterThreshold = 2000;
+
+signals:
+    void optionsChanged();
+    void multipleChanged();
+    void filterChanged();
+    void filteringChanged();
+    void countChanged();
+    void selectionChanged();
+
+private slots:
+    void filterFinished(uint generation);
+
+public:
+    // Filtering state shared with the worker thread.
+    struct FilterJob
+    {
+        uint generation;
+        QString filter;
+        QVector<QString> labels;
+        // Options to match, all when allOptions is set.
+        QVector<int> candidates;
+        bool allOptions;
+        QVector<int> rows;
+
+        QMutex mutex;
+        QObject *receiver = nullptr;
+    };
+
+    static void runFilter(FilterJob *job);
+
+private:
+    struct Option
+    {
+        QString group;
+        int index;
+        bool selected;
+        bool initiallySelected;
+        bool disabled;
+    };
+
+    void detachFilterJob();
+    void setSelected(int option, bool selected);
+    void setRows(const QVector<int> &rows);
+
+    QVariant m_options;
+    QVector<Option> m_optionList;
+    // Shared with filter jobs.
+    QVector<QString> m_labels;
+    // Rows of the model, indexes to m_optionList.
+    QVector<int> m_rows;
+    bool m_multiple;
+    QString m_filter;
+    // The filter m_rows are the result of.
+    QString m_appliedFilter;
+    uint m_filterGeneration;
+    std::shared_ptr<FilterJob> m_filterJob;
+};
+
+} // namespace Pickers
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#endif // SAILFISHOS_WEBVIEW_PICKERS_SELECTMODEL_H
@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+pragma Singleton
+import QtQml 2.2
+
+// Shared, process wide cache of popup components. Components are compiled
+// asynchronously so that the GUI thread is not blocked when a popup is needed.
+QtObject {
+    id: root
+
+    property bool preloaded
+    property var _components: ({})
+
+    // Popups used by views that don't set their own provider. Only holds
+    // component urls and types, so it is shared by all views.
+    readonly property PopupProvider defaultProvider: PopupProvider {}
+
+    // Calls readyFn(component) once the component for the given url is ready,
+    // or the optional errorFn() if it fails to load. Inline components are
+    // passed through as is.
+    function load(comp, readyFn, errorFn) {
+        if (comp.createObject !== undefined) {
+            readyFn(comp)
+            return
+        }
+
+        var url = comp.toString()
+        var component = _components[url]
+        if (!component) {
+            component = Qt.createComponent(url, Component.Asynchronous)
+            if (!component) {
+                console.log("PopupComponentCache.qml: unable to create component from", url)
+                if (errorFn) {
+                    errorFn()
+                }
+                return
+            }
+            _components[url] = component
+        }
+
+        if (component.status === Component.Loading) {
+            var statusChanged = function() {
+                if (component.status !== Component.Loading) {
+                    component.statusChanged.disconnect(statusChanged)
+                    _finishLoad(url, component, readyFn, errorFn)
+                }
+            }
+            component.statusChanged.connect(statusChanged)
+        } else {
+            _finishLoad(url, component, readyFn, errorFn)
+        }
+    }
+
+    // Compiles the given component urls in the background.
+    function preload(urls) {
+        for (var i = 0; i < urls.length; ++i) {
+            load(urls[i], function() {})
+        }
+        preloaded = true
+    }
+
+    function _finishLoad(url, component, readyFn, errorFn) {
+        if (component.status === Component.Ready) {
+            readyFn(component)
+        } else {
+            console.log("PopupComponentCache.qml: error loading component", url)
+            if (component.status === Component.Error) {
+                console.log("PopupComponentCache.qml: error:", component.errorString())
+            } else if (component.status === Component.Null) {
+                console.log("PopupComponentCache.qml: error: component is null")
+            }
+            // Allow a later request to retry.
+            delete _components[url]
+            if (errorFn) {
+                errorFn()
+            }
+        }
+    }
+}
@@ -14,6 +14,7 @@ import Sailfish.Silica 1.0
 import Sailfish.WebEngine 1.0
 import Sailfish.WebView.Popups 1.0 as Popups
 import Sailfish.WebView.Controls 1.0 as Controls
+import "PopupTopics.js" as PopupTopics
 
 Timer {
     id: root
@@ -25,26 +26,22 @@ Timer {
     readonly property bool active: contextMenu && contextMenu.active || false
     property Item contextMenu
 
-    property PopupProvider popupProvider: PopupProvider {}
-    readonly property var _messageTopicToPopupProviderPropertyMapping: ({
-        "Content:ContextMenu":  "contextMenu",
-        "embed:alert":          "alertPopup",
-        "embed:confirm":        "confirmPopup",
-        "embed:prompt":         "promptPopup",
-        "embed:login":          "passwordManagerPopup",
-        "embed:auth":           "authPopup",
-        "embed:permissions":  { "geolocation": "locationPermissionPopup" },
-        "embed:webrtcrequest":  "webrtcPermissionPopup",
-        "embed:popupblocked":   "blockedTabPopup",
-        "embed:select":         "selectorPopup"
-    })
-    readonly property var listeners: Object.keys(_messageTopicToPopupProviderPropertyMapping)
+    property PopupProvider popupProvider: Popups.PopupComponentCache.defaultProvider
+    readonly property var _messageTopicToPopupProviderPropertyMapping: PopupTopics.popupProviderProperties
+    readonly property var listeners: PopupTopics.listeners
 
     property bool downloadsEnabled: true
 
     property Component _contextMenuComponent
+    property bool _contextMenuIncubating
     property var _popupObject
     property var _delayedOpenValues
+    // Increased by reset(), popups of earlier requests are not opened
+    property int _generation
+    property PopupRequestQueue _requestQueue: PopupRequestQueue {
+        onRequestReady: root._showRequest(request)
+        onRequestDropped: root._dropRequest(request)
+    }
 
     property Notice positioningDisabledNotice: Notice {
         duration: 3000
@@ -120,9 +117,6 @@ Timer {
 
         aboutToOpenPopup(topic, data)
 
-        _delayedOpenValues = null
-        _popupObject = null
-
         switch (topic) {
         case "Content:ContextMenu": root._openContextMenu(data); break;
         case "embed:alert":         alert(data);    break;
@@ -484,7 +478,9 @@ Timer {
                       root._delayedOpenValues[1],
                       root._delayedOpenValues[2],
                       root._delayedOpenValues[3],
-                      root._delayedOpenValues[4])
+                      root._delayedOpenValues[4],
+                      root._delayedOpenValues[5],
+                      root._delayedOpenValues[6])
             root._delayedOpenValues = null
         }
     }
@@ -493,40 +489,70 @@ Timer {
         return listeners.indexOf(topic) >= 0
     }
 
-    function openPopup(comp, properties, isDialog, acceptedFn, rejectedFn) {
+    // openedFn, if given, is called with the popup once it is shown.
+    function openPopup(comp, properties, isDialog, acceptedFn, rejectedFn, errorFn, openedFn) {
+        // Components are compiled asynchronously, the popup is opened once ready.
+        Popups.PopupComponentCache.load(comp, function(component) {
+            _openLoadedPopup(component, properties, isDialog, acceptedFn, rejectedFn, errorFn, openedFn)
+        }, errorFn)
+    }
+
+    function _openLoadedPopup(component, properties, isDialog, acceptedFn, rejectedFn, errorFn, openedFn) {
+        var generation = _generation
+        if (!pageStack) {
+            if (errorFn) {
+                errorFn()
+            }
+            return
+        }
+
         if (pageStack.busy) {
-            _delayedOpenValues = [comp, properties, isDialog, acceptedFn, rejectedFn]
+            _delayedOpenValues = [component, properties, isDialog, acceptedFn, rejectedFn, errorFn, openedFn]
             pageStack.busyChanged.connect(busyChanged)
             return
         }
 
-        var obj = null
         if (isDialog) {
-            obj = pageStack.animatorPush(comp, properties)
+            var obj = pageStack.animatorPush(component, properties)
             obj.pageCompleted.connect(function(dialog) {
-                // TODO: also the Async message must be sent when window gets closed
+                if (generation !== _generation) {
+                    dialog.reject()
+                    return
+                }
                 _popupObject = dialog // prevent gc()
                 dialog.accepted.connect(function() { acceptedFn(dialog) })
                 dialog.rejected.connect(function() { rejectedFn(dialog) })
+                if (openedFn) {
+                    openedFn(dialog)
+                }
             })
         } else {
-            var component = comp.createObject === undefined
-                          ? Qt.createComponent(comp) // TODO: asynchronous...
-                          : comp
-            if (!component) {
-                console.log("PopupOpener.qml: unable to create component from", comp)
-            } else if (component.status !== Component.Ready) {
-                console.log("PopupOpener.qml: error loading component", comp)
-                if (component.status === Component.Error) {
-                    console.log("PopupOpener.qml: error:", component.errorString())
-                } else if (component.status === Component.Null) {
-                    console.log("PopupOpener.qml: error: component is null")
+            var incubator = component.incubateObject(parentItem, properties)
+            var incubated = function(popup) {
+                if (generation !== _generation) {
+                    popup.destroy()
+                    return
+                }
+                _popupObject = popup // prevent gc()
+                popup.accepted.connect(function() { acceptedFn(popup) })
+                popup.rejected.connect(function() { rejectedFn(popup) })
+                if (openedFn) {
+                    openedFn(popup)
+                }
+            }
+            if (incubator.status !== Component.Ready) {
+                incubator.onStatusChanged = function(status) {
+                    if (status === Component.Ready) {
+                        incubated(incubator.object)
+                    } else if (status === Component.Error) {
+                        console.log("PopupOpener.qml: unable to incubate popup", component.url)
+                        if (errorFn) {
+                            errorFn()
+                        }
+                    }
                 }
             } else {
-                obj = component.createObject(parentItem, properties)
-                _popupObject = obj // prevent gc()
-                obj.accepted.connect(function() { acceptedFn(obj) })
-                obj.rejected.connect(function() { rejectedFn(obj) })
+                incubated(incubator.object)
             }
         }
     }
@@ -537,10 +563,125 @@ Timer {
         if (comp === null || comp === undefined) {
             console.log("PopupOpener.qml: invalid component specified for: " + topic + " " + subtopic)
         } else {
-            openPopup(comp, properties, compIsDialog, acceptedFn, rejectedFn)
+            _requestQueue.enqueue({
+                "topic": topic,
+                "origin": properties.origin || properties.host || properties.hostname
+                          || _urlOrigin(contentItem.url),
+                // Requests answered through their _internalData, e.g. logins,
+                // are only coalesced when it matches as well.
+                "key": JSON.stringify([subtopic, properties], function(key, value) {
+                    return key === "contentItem" ? undefined : value
+                }),
+                "component": comp,
+                "isDialog": compIsDialog,
+                "properties": properties,
+                "acceptedFn": acceptedFn,
+                "rejectedFn": rejectedFn
+            })
+        }
+    }
+
+    function _showRequest(request) {
+        // Coalesced requests get the same answer as the one that is shown.
+        var respond = function(popup, accepted) {
+            if (request.answered) {
+                // Already answered by reset().
+                return
+            }
+            request.answered = true
+            var requests = [request].concat(request.duplicates)
+            for (var i = 0; i < requests.length; ++i) {
+                if (accepted) {
+                    requests[i].acceptedFn(popup)
+                } else {
+                    requests[i].rejectedFn(popup)
+                }
+            }
+            _requestQueue.finish(request)
+        }
+
+        openPopup(request.component, request.properties, request.isDialog,
+                  function(popup) { respond(popup, true) },
+                  function(popup) { respond(popup, false) },
+                  function() {
+                      _dropRequest(request)
+                      _requestQueue.finish(request)
+                  },
+                  function(popup) {
+                      if (request.answered) {
+                          // Dropped by the queue before it could be shown.
+                          _closePopup(popup)
+                      } else {
+                          // A popup closed without an answer, e.g. a page
+                          // popped by the application, is answered as
+                          // dismissed.
+                          _requestQueue.opened(request, popup)
+                      }
+                  })
+    }
+
+    function _closePopup(popup) {
+        if (_popupObject === popup) {
+            _popupObject = null
+        }
+        if (typeof popup.reject === "function") {
+            popup.reject()
+        } else {
+            popup.destroy()
         }
     }
 
+    function _dropRequest(request) {
+        if (request.answered) {
+            return
+        }
+        request.answered = true
+
+        // Reject as if the user had dismissed the popup with default values.
+        var requests = [request].concat(request.duplicates)
+        for (var i = 0; i < requests.length; ++i) {
+            var popup = {
+                "preventDialogsValue": false,
+                "rememberValue": false,
+                "choices": {}
+            }
+            for (var property in requests[i].properties) {
+                popup[property] = requests[i].properties[property]
+            }
+            requests[i].rejectedFn(popup)
+        }
+    }
+
+    // Called when the view is reused for another page, e.g. by WebViewPool.
+    // Waiting requests are answered as dismissed and the shown popup is
+    // closed, nothing of the previous page is left on screen.
+    function reset() {
+        ++_generation
+        if (_delayedOpenValues) {
+            pageStack.busyChanged.disconnect(busyChanged)
+            _delayedOpenValues = null
+        }
+
+        var popup = _popupObject
+        _popupObject = null
+        _requestQueue.abort()
+        if (popup) {
+            _closePopup(popup)
+        }
+
+        // Created again for the next page, it holds the previous link.
+        if (contextMenu) {
+            contextMenu.destroy()
+            contextMenu = null
+        }
+    }
+
+    function _urlOrigin(url) {
+        var urlString = url ? url.toString() : ""
+        var match = /^[a-z][a-z0-9+.-]*:\/\/[^\/?#]*/i.exec(urlString)
+        return match ? match[0] : urlString
+    }
+
     function _openContextMenu(data) {
         root.aboutToOpenContextMenu(data)
         if (data.types.indexOf("image") !== -1 || data.types.indexOf("link") !== -1) {
@@ -559,10 +700,12 @@ Timer {
                 contextMenu.viewId = contentItem.uniqueId
                 contextMenu.pageStack = root.pageStack
                 contextMenu.show()
-            } else {
-                _contextMenuComponent = Qt.createComponent(_resolveListenerComponent("Content:ContextMenu"))
-                if (_contextMenuComponent.status !== Component.Error) {
-                    contextMenu = _contextMenuComponent.createObject(parentItem, {
+            } else if (!_contextMenuIncubating) {
+                _contextMenuIncubating = true
+                var generation = _generation
+                Popups.PopupComponentCache.load(_resolveListenerComponent("Content:ContextMenu"), function(component) {
+                    _contextMenuComponent = component
+                    var incubator = component.incubateObject(parentItem, {
                         "linkHref": linkHref,
                         "imageSrc": imageSrc,
                         "linkTitle": linkTitle && linkTitle.trim() || "",
@@ -573,21 +716,51 @@ Timer {
                         "pageStack": pageStack,
                         "downloadsEnabled": root.downloadsEnabled
                     })
-                    contextMenu.show()
-                } else {
-                    console.log("Can't load ContextMenu component")
-                }
+                    var incubated = function(menu) {
+                        _contextMenuIncubating = false
+                        if (generation !== _generation) {
+                            menu.destroy()
+                            return
+                        }
+                        contextMenu = menu
+                        contextMenu.show()
+                    }
+                    if (incubator.status !== Component.Ready) {
+                        incubator.onStatusChanged = function(status) {
+                            if (status === Component.Ready) {
+                                incubated(incubator.object)
+                            } else if (status === Component.Error) {
+                                _contextMenuIncubating = false
+                                console.log("Can't load ContextMenu component")
+                            }
+                        }
+                    } else {
+                        incubated(incubator.object)
+                    }
+                })
             }
         }
     }
 
+    // Compiles the default popup components in the background so that
+    // the first popup does not need to wait for QML compilation.
+    function preloadComponents() {
+        if (!Popups.PopupComponentCache.preloaded) {
+            Popups.PopupComponentCache.preload(PopupTopics.componentUrls(popupProvider))
+        }
+    }
+
     Component.onCompleted: {
         // Warmup location settings.
         Popups.LocationSettings.locationEnabled
         Controls.PermissionManager.instance()
         if (contentItem) {
-            for (var i = 0; i < listeners.length; ++i) {
-                contentItem.addMessageListener(listeners[i])
+            if (contentItem.addMessageListeners) {
+                contentItem.addMessageListeners(listeners)
+            } else {
+                for (var i = 0; i < listeners.length; ++i) {
+                    contentItem.addMessageListener(listeners[i])
+                }
             }
         } else {
             console.log("PopupOpener has no contentItem. Each created WebView/WebPage",
@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+import QtQml 2.2
+
+// Serializes popup requests of a single view. Identical consecutive requests
+// are coalesced into one and requests exceeding the per origin rate limit are
+// dropped. Dropped requests are handed back through requestDropped() so that
+// the owner can answer them and the content process does not wait forever.
+//
+// A request is an object with at least "topic", "origin" and "key" fields.
+// Coalesced requests are collected to the "duplicates" array of the request
+// that is shown.
+//
+// The shown request is dropped if its popup is not opened within
+// openTimeout or goes away without an answer, so that a lost popup does not
+// hold back the popups that follow.
+QtObject {
+    id: root
+
+    // Maximum number of requests from the same origin within originRateInterval
+    property int originRateLimit: 5
+    property int originRateInterval: 3000
+    // Maximum number of requests waiting to be shown
+    property int maximumLength: 20
+    // Milliseconds the owner has to open the popup of the shown request
+    property int openTimeout: 10000
+
+    readonly property int count: _pending.length
+    readonly property bool busy: _current !== null
+
+    property var _current: null
+    property var _pending: []
+    property var _originHistory: ({})
+    property Timer _openWatchdog: Timer {
+        interval: root.openTimeout
+        onTriggered: root._abandon(root._current)
+    }
+
+    signal requestReady(var request)
+    signal requestDropped(var request)
+
+    // Returns false if the request was dropped.
+    function enqueue(request) {
+        request.duplicates = []
+
+        var previous = _pending.length > 0 ? _pending[_pending.length - 1] : _current
+        if (previous && previous.topic === request.topic && previous.key === request.key) {
+            previous.duplicates.push(request)
+            return true
+        }
+
+        if (!_allowOrigin(request.origin) || _pending.length >= maximumLength) {
+            requestDropped(request)
+            return false
+        }
+
+        if (_current === null) {
+            _show(request)
+        } else {
+            var pending = _pending
+            pending.push(request)
+            _pending = pending
+        }
+        return true
+    }
+
+    // Called by the owner once the shown request has been answered.
+    function finish(request) {
+        if (request !== _current) {
+            return
+        }
+
+        _current = null
+        _openWatchdog.stop()
+        if (_pending.length > 0) {
+            var pending = _pending
+            var next = pending.shift()
+            _pending = pending
+            _show(next)
+        }
+    }
+
+    // Called by the owner once the popup of the shown request is open.
+    function opened(request, popup) {
+        if (request !== _current) {
+            return
+        }
+
+        _openWatchdog.stop()
+        popup.Component.destruction.connect(function() {
+            root._abandon(request)
+        })
+    }
+
+    // Drops all requests that have not been shown yet.
+    function clear() {
+        var pending = _pending
+        _pending = []
+        for (var i = 0; i < pending.length; ++i) {
+            requestDropped(pending[i])
+        }
+    }
+
+    // Drops all requests, including the one that is shown, and forgets the
+    // origins seen so far. The owner closes the popup of the shown request.
+    function abort() {
+        clear()
+        _originHistory = {}
+
+        var current = _current
+        _current = null
+        _openWatchdog.stop()
+        if (current) {
+            requestDropped(current)
+        }
+    }
+
+    function _show(request) {
+        _current = request
+        _openWatchdog.restart()
+        requestReady(request)
+    }
+
+    // The popup of the shown request went away without an answer, or was
+    // never opened.
+    function _abandon(request) {
+        if (!request || request !== _current) {
+            return
+        }
+
+        requestDropped(request)
+        finish(request)
+    }
+
+    function _allowOrigin(origin) {
+        if (originRateLimit <= 0) {
+            return true
+        }
+
+        var now = Date.now()
+        var history = (_originHistory[origin] || []).filter(function(timestamp) {
+            return now - timestamp < originRateInterval
+        })
+        var allowed = history.length < originRateLimit
+        if (allowed) {
+            history.push(now)
+        }
+        _originHistory[origin] = history
+        return allowed
+    }
+}
@@ -0,0 +1,50 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+.pragma library
+
+// Message topics handled by PopupOpener and the PopupProvider properties
+// holding their popups. Shared by all views so that the topics can be
+// registered before a PopupOpener is created.
+var popupProviderProperties = {
+    "Content:ContextMenu":  "contextMenu",
+    "embed:alert":          "alertPopup",
+    "embed:confirm":        "confirmPopup",
+    "embed:prompt":         "promptPopup",
+    "embed:login":          "passwordManagerPopup",
+    "embed:auth":           "authPopup",
+    "embed:permissions":  { "geolocation": "locationPermissionPopup" },
+    "embed:webrtcrequest":  "webrtcPermissionPopup",
+    "embed:popupblocked":   "blockedTabPopup",
+    "embed:select":         "selectorPopup"
+}
+
+var listeners = Object.keys(popupProviderProperties)
+
+// Urls of the popup components of the provider that need compiling.
+// Inline components are already compiled along with their context.
+function componentUrls(provider) {
+    var urls = []
+    for (var i = 0; i < listeners.length; ++i) {
+        var providerProperty = popupProviderProperties[listeners[i]]
+        var providerProperties = (typeof providerProperty === 'string')
+                ? [providerProperty]
+                : Object.keys(providerProperty).map(function(subtopic) { return providerProperty[subtopic] })
+        for (var j = 0; j < providerProperties.length; ++j) {
+            var resolvedProperty = provider[providerProperties[j]]
+            if (resolvedProperty && resolvedProperty.hasOwnProperty("component")
+                    && (typeof resolvedProperty.component === 'string'
+                        || resolvedProperty.component instanceof String)) {
+                urls.push(Qt.resolvedUrl(resolvedProperty.component))
+            }
+        }
+    }
+    return urls
+}
@@ -1,33 +1,10 @@
-
-// Convert from camelCase to snake_case
-// Must exactly match the outputs from generate_property_translations.py _convert_key()
-function _convert_key(name, prefix) {
-    prefix = (typeof prefix !== "undefined") ? prefix : "sailfish_components_webview_popups-la"
-    var snake = name.replace(/([a-z\d]+)([A-Z])/g,"$1_$2").toLowerCase()
-    return snake.length ? "%1-%2".arg(prefix).arg(snake) : ""
-}
+.import Sailfish.WebView.Popups 1.0 as Popups
 
 // Convert a gecko key to a translated string via a Qt translation Id
 // textBunlde is either a gecko key, or an array containing a key followed by
 // input parameters
-function geckoKeyToString(textBundle, prefix) {
-    var string
-    var bundle = (typeof textBundle !== "string")
-    var key = bundle ? textBundle[0] : textBundle
-    var id = _convert_key(key)
-    string = qsTrId(id)
-    if (string === id) {
-        // If the key has no translation, use the original gecko key instead
-        // since it may be a pre-translated string
-        string = key
-    }
-    if (bundle) {
-        for (var input = 1; input < textBundle.length; ++input) {
-            string = string.arg(textBundle[input])
-        }
-    }
-
-    return string
+function geckoKeyToString(textBundle) {
+    return Popups.GeckoTranslations.translate(textBundle)
 }
 
 // Trim the input to the maximum and add an ellipsis (or local equivalent) if needed
@@ -0,0 +1,142 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "geckotranslations.h"
+
+#include <QtCore/QStringList>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace SailfishOS {
+
+namespace WebView {
+
+namespace Popups {
+
+namespace {
+
+constexpr char TRANSLATION_ID_PREFIX[] = "sailfish_components_webview_popups-la-";
+
+struct TranslationEntry
+{
+    const char *key;
+    const char *id;
+};
+
+// Sorted by key, regenerate with
+// tools/generate_property_translations.py --table
+constexpr TranslationEntry translationTable[] = {
+#include "generated/translationtable.inc"
+};
+
+constexpr std::size_t translationTableSize = sizeof(translationTable) / sizeof(translationTable[0]);
+
+// Same order as std::strcmp, single return statements for C++11.
+constexpr bool keyLessThan(const char *left, const char *right)
+{
+    return *left == *right
+            ? *left != '\0' && keyLessThan(left + 1, right + 1)
+            : static_cast<unsigned char>(*left) < static_cast<unsigned char>(*right);
+}
+
+constexpr bool isSorted(const TranslationEntry *table, std::size_t count)
+{
+    return count < 2 || (keyLessThan(table[0].key, table[1].key) && isSorted(table + 1, count - 1));
+}
+
+static_assert(isSorted(translationTable, translationTableSize),
+              "The translation table must be sorted by key for the binary search");
+
+bool entryLessThan(const TranslationEntry &entry, const char *key)
+{
+    return std::strcmp(entry.key, key) < 0;
+}
+
+}
+
+GeckoTranslations::GeckoTranslations(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QObject *GeckoTranslations::create(QQmlEngine *engine, QJSEngine *scriptEngine)
+{
+    Q_UNUSED(engine)
+    Q_UNUSED(scriptEngine)
+    return new GeckoTranslations;
+}
+
+QString GeckoTranslations::translate(const QVariant &textBundle) const
+{
+    QVariantList arguments;
+    QString key;
+    if (textBundle.type() == QVariant::String) {
+        key = textBundle.toString();
+    } else {
+        arguments = textBundle.toList();
+        if (!arguments.isEmpty()) {
+            key = arguments.takeFirst().toString();
+        }
+    }
+
+    const QByteArray id = translationId(key);
+    QString string = qtTrId(id.constData());
+    if (string == QLatin1String(id)) {
+        // If the key has no translation, use the original gecko key instead
+        // since it may be a pre-translated string
+        string = key;
+    }
+
+    for (const QVariant &argument : arguments) {
+        string = string.arg(argument.toString());
+    }
+
+    return string;
+}
+
+QByteArray GeckoTranslations::translationId(const QString &key)
+{
+    if (key.isEmpty()) {
+        return QByteArray();
+    }
+
+    const QByteArray utf8Key = key.toUtf8();
+    const TranslationEntry *end = translationTable + translationTableSize;
+    const TranslationEntry *entry = std::lower_bound(translationTable, end, utf8Key.constData(), entryLessThan);
+    if (entry != end && std::strcmp(entry->key, utf8Key.constData()) == 0) {
+        return QByteArray::fromRawData(entry->id, std::strlen(entry->id));
+    }
+
+    // Same as the conversion of the generator, an underscore goes between
+    // a lower case letter or a digit and the upper case letter after it.
+    QByteArray id(TRANSLATION_ID_PREFIX);
+    id.reserve(id.size() + utf8Key.size() * 2);
+    for (int i = 0; i < utf8Key.size(); ++i) {
+        const char c = utf8Key.at(i);
+        if (c >= 'A' && c <= 'Z') {
+            const char previous = i > 0 ? utf8Key.at(i - 1) : 0;
+            if ((previous >= 'a' && previous <= 'z') || (previous >= '0' && previous <= '9')) {
+                id.append('_');
+            }
+            id.append(c - 'A' + 'a');
+        } else {
+            id.append(c);
+        }
+    }
+    return id;
+}
+
+} // namespace Popups
+
+} // namespace WebView
+
+} // namespace SailfishOS
@@ -0,0 +1,53 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_WEBVIEW_POPUPS_GECKOTRANSLATIONS_H
+#define SAILFISHOS_WEBVIEW_POPUPS_GECKOTRANSLATIONS_H
+
+#include <QtCore/QObject>
+#include <QtCore/QVariant>
+
+class QJSEngine;
+class QQmlEngine;
+
+namespace SailfishOS {
+
+namespace WebView {
+
+namespace Popups {
+
+// Translates gecko property keys, such as the messageBundle of an auth
+// prompt, with the ids generate_property_translations.py produced.
+class GeckoTranslations : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GeckoTranslations(QObject *parent = nullptr);
+
+    static QObject *create(QQmlEngine *engine, QJSEngine *scriptEngine);
+
+    // textBundle is either a gecko key or a list of a key followed by the
+    // arguments of the string. Keys without a translation are returned
+    // as such, they may be translated already.
+    Q_INVOKABLE QString translate(const QVariant &textBundle) const;
+
+    // The translation id of a gecko key, the generated table is looked up
+    // first and camelCase is converted to snake_case for other keys.
+    static QByteArray translationId(const QString &key);
+};
+
+} // namespace Popups
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#endif // SAILFISHOS_WEBVIEW_POPUPS_GECKOTRANSLATIONS_H
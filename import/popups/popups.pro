@@ -13,8 +13,13 @@ QT += qml quick
 
 QMAKE_CXXFLAGS += -fPIC
 
-HEADERS += popupsplugin.h
-SOURCES += popupsplugin.cpp
+INCLUDEPATH += ../../lib
+LIBS += -L../../lib -lsailfishwebengine
+
+HEADERS += geckotranslations.h \
+           popupsplugin.h
+SOURCES += geckotranslations.cpp \
+           popupsplugin.cpp
 OTHER_FILES += qmldir plugins.qmltypes *.qml
 
 include(popupstranslations.pri)
@@ -25,6 +30,9 @@ target.path = $$TARGETPATH
 
 INSTALLS += target import translations_install engineering_english_install
 
+QMLCACHE_FILES = $$files(*.qml) $$files(*.js)
+include(../qmlcache.pri)
+
 # The module is verbose on stdout, hence the use of dedicated FD for output.
 #
 # HACK: pass -nocomposites to work around the issue with types leaked
@@ -10,6 +10,8 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "popupsplugin.h"
+#include "geckotranslations.h"
+#include "translationregistry.h"
 
 #include <QtQml/QQmlEngine>
 #include <QtQml/QQmlContext>
@@ -26,16 +28,26 @@ namespace Popups {
 void SailfishOSWebViewPopupsPlugin::registerTypes(const char *uri)
 {
     Q_ASSERT(uri == QLatin1String("Sailfish.WebView.Popups"));
+    qmlRegisterSingletonType<GeckoTranslations>("Sailfish.WebView.Popups", 1, 0, "GeckoTranslations",
+                                                GeckoTranslations::create);
 }
 
 void SailfishOSWebViewPopupsPlugin::initializeEngine(QQmlEngine *engine, const char *uri)
 {
     Q_ASSERT(uri == QLatin1String("Sailfish.WebView.Popups"));
 
-    AppTranslator *engineeringEnglish = new AppTranslator(engine);
-    AppTranslator *translator = new AppTranslator(engine);
-    engineeringEnglish->load("sailfish_components_webview_popups_qt5_eng_en", "/usr/share/translations");
-    translator->load(QLocale(), "sailfish_components_webview_popups_qt5", "-", "/usr/share/translations");
+    // Loaded when the first popup is opened.
+    TranslationRegistry::instance()->addCatalog(
+                engine, QStringLiteral("sailfish_components_webview_popups_qt5"),
+                QStringList() << QStringLiteral("sailfish_components_webview_popups-")
+                              << QStringLiteral("sailfish_components_webview_popupopener-"));
+
+    // Shared with the browser, a prefix would load the catalog for every
+    // string of the browser.
+    TranslationRegistry::instance()->addCatalogIds(
+                QStringLiteral("sailfish_components_webview_popups_qt5"),
+                QStringList() << QStringLiteral("sailfish_browser-he-share_link")
+                              << QStringLiteral("sailfish_browser-he-share"));
 }
 
 } // namespace Popups
@@ -15,7 +15,6 @@
 #include <QtQml/QQmlExtensionPlugin>
 #include <QtQuick/QQuickItem>
 
-#include <QtCore/QTranslator>
 #include <QtCore/QLocale>
 #include <QtCore/QObject>
 #include <QtCore/QStandardPaths>
@@ -36,24 +35,6 @@ public:
     void initializeEngine(QQmlEngine *engine, const char *uri);
 };
 
-// using custom translator so it gets properly removed from qApp when engine is deleted
-class AppTranslator: public QTranslator
-{
-    Q_OBJECT
-
-public:
-    AppTranslator(QObject *parent)
-        : QTranslator(parent)
-    {
-        qApp->installTranslator(this);
-    }
-
-    virtual ~AppTranslator()
-    {
-        qApp->removeTranslator(this);
-    }
-};
-
 } // namespace Popups
 
 } // namespace WebView
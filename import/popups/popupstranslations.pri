@@ -26,4 +26,4 @@ QMAKE_EXTRA_TARGETS += translations engineering_english
 
 PRE_TARGETDEPS += translations engineering_english
 
-OTHER_FILES += generated/*.cpp
+OTHER_FILES += generated/*.cpp generated/*.inc
@@ -0,0 +1,31 @@
+# Ahead-of-time compiled QML and JavaScript of a module.
+#
+# Set QMLCACHE_FILES and TARGETPATH before including. The .qmlc and .jsc
+# files are installed next to their sources. The engine checks a cache file
+# against its source and compiles the source at runtime when the cache file
+# is missing or stale, or when QML_DISABLE_DISK_CACHE is set. Without
+# qmlcachegen (Qt < 5.9) or with CONFIG+=no_qmlcache nothing is generated
+# and all QML is compiled at runtime as before.
+
+QMLCACHEGEN = $$[QT_HOST_BINS]/qmlcachegen
+
+!no_qmlcache:exists($$QMLCACHEGEN) {
+    # Older qmlcachegen emits native code and needs to know the target.
+    lessThan(QT_MAJOR_VERSION, 6):lessThan(QT_MINOR_VERSION, 11) {
+        QMLCACHEGEN_ARGS = --target-architecture=$$QT_ARCH
+    }
+
+    qmlcachegen.input = QMLCACHE_FILES
+    qmlcachegen.output = ${QMAKE_FILE_IN_BASE}${QMAKE_FILE_EXT}c
+    qmlcachegen.commands = $$QMLCACHEGEN $$QMLCACHEGEN_ARGS -o ${QMAKE_FILE_OUT} ${QMAKE_FILE_IN}
+    qmlcachegen.name = Generating QML cache ${QMAKE_FILE_IN}
+    qmlcachegen.CONFIG = no_link target_predeps
+    QMAKE_EXTRA_COMPILERS += qmlcachegen
+
+    for(file, QMLCACHE_FILES): qmlcache.files += $$OUT_PWD/$${file}c
+    qmlcache.path = $$TARGETPATH
+    qmlcache.CONFIG = no_check_exist
+    INSTALLS += qmlcache
+} else {
+    message("Not generating QML cache for $$MODULENAME, QML is compiled at runtime")
+}
@@ -24,6 +24,15 @@ template <typename T> static QObject *singletonApiFactory(QQmlEngine *engine, QJ
     return new T(engine);
 }
 
+// The settings of the views are changed through the C++ instance, share it
+// so that QML sees its change signals.
+static QObject *webEngineSettingsFactory(QQmlEngine *, QJSEngine *)
+{
+    SailfishOS::WebEngineSettings *engineSettings = SailfishOS::WebEngineSettings::instance();
+    QQmlEngine::setObjectOwnership(engineSettings, QQmlEngine::CppOwnership);
+    return engineSettings;
+}
+
 class SailfishOSWebEnginePlugin : public QQmlExtensionPlugin
 {
     Q_OBJECT
@@ -45,7 +54,7 @@ public:
         qmlRegisterSingletonType<SailfishOS::WebEngine>("Sailfish.WebEngine", 1, 0, "WebEngine",
                                                         singletonApiFactory<SailfishOS::WebEngine>);
         qmlRegisterSingletonType<SailfishOS::WebEngineSettings>("Sailfish.WebEngine", 1, 0, "WebEngineSettings",
-                                                                singletonApiFactory<SailfishOS::WebEngineSettings>);
+                                                                webEngineSettingsFactory);
         qmlRegisterSingletonType<SailfishOS::WebEngineUtils::DownloadHelper>("Sailfish.WebEngine", 1, 0,
                                                                              "DownloadHelper",
                                                                              singletonApiFactory<SailfishOS::WebEngineUtils::DownloadHelper>);
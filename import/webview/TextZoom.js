@@ -5,19 +5,35 @@
 (function() {
     "use strict";
 
-    function applyTextZoom(message) {
-        var data = message.data || message.json || {};
-        var zoom = Number(data.zoom);
+    function setTextZoom(value) {
+        var zoom = Number(value);
 
         if (!isFinite(zoom) || zoom <= 0) {
             zoom = 1.0;
         }
 
+        // The browsing context keeps its zoom over navigations, a zoom it
+        // already has would only cause another reflow.
         try {
-            docShell.browsingContext.textZoom = zoom;
+            var browsingContext = docShell.browsingContext;
+            if (browsingContext.textZoom !== zoom) {
+                browsingContext.textZoom = zoom;
+            }
         } catch (e) {
         }
     }
 
+    function applyTextZoom(message) {
+        var data = message.data || message.json || {};
+        setTextZoom(data.zoom);
+    }
+
+    // Sent once by RawWebView before the first load.
+    function applyInitialState(message) {
+        var data = message.data || message.json || {};
+        setTextZoom(data.textZoom);
+    }
+
     addMessageListener("embedui:textZoom", applyTextZoom);
+    addMessageListener("embedui:viewInitialState", applyInitialState);
 })();
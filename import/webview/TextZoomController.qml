@@ -16,11 +16,17 @@ QtObject {
 
     property var webPage
     property bool _frameScriptLoaded
+    // Zoom last sent to the browsing context of webPage, 0 if none
+    property real _appliedTextZoom
 
     readonly property real textZoom: Math.pow(Theme.fontSizeMedium / Theme.fontSizeMediumBase, 1.25)
 
+    // RawWebView loads TextZoom.js into its own frames and applies its
+    // textZoom property before the first load.
+    readonly property bool _nativeTextZoom: !!webPage && webPage.textZoom !== undefined
+
     property Connections webPageConnections: Connections {
-        target: controller.webPage
+        target: controller._nativeTextZoom ? null : controller.webPage
         onDomContentLoadedChanged: {
             if (controller.webPage.domContentLoaded) {
                 controller.updateTextZoom()
@@ -33,18 +39,26 @@ QtObject {
             return
         }
 
+        if (_nativeTextZoom) {
+            webPage.textZoom = textZoom
+            return
+        }
+
         if (!_frameScriptLoaded) {
             webPage.loadFrameScript(Qt.resolvedUrl("TextZoom.js"))
             _frameScriptLoaded = true
         }
 
-        if (webPage.domContentLoaded) {
+        // The browsing context keeps the zoom over navigations.
+        if (webPage.domContentLoaded && _appliedTextZoom !== textZoom) {
             webPage.sendAsyncMessage("embedui:textZoom", { "zoom": textZoom })
+            _appliedTextZoom = textZoom
         }
     }
 
     onWebPageChanged: {
         _frameScriptLoaded = false
+        _appliedTextZoom = 0
         updateTextZoom()
     }
 
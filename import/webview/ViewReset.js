@@ -0,0 +1,34 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+(function() {
+    "use strict";
+
+    // Sent by RawWebView when the view is put to WebViewPool. The next user
+    // of the view starts from about:blank without back or forward entries.
+    function resetView() {
+        var webNavigation = docShell.QueryInterface(Ci.nsIWebNavigation);
+
+        try {
+            webNavigation.stop(Ci.nsIWebNavigation.STOP_ALL);
+        } catch (e) {
+        }
+
+        try {
+            var history = webNavigation.sessionHistory;
+            var legacyHistory = history.legacySHistory || history;
+            if (legacyHistory.count > 0) {
+                legacyHistory.purgeHistory(legacyHistory.count);
+            }
+        } catch (e) {
+        }
+
+        webNavigation.loadURI("about:blank", {
+            triggeringPrincipal: Services.scriptSecurityManager.getSystemPrincipal(),
+            loadFlags: Ci.nsIWebNavigation.LOAD_FLAGS_REPLACE_HISTORY
+        });
+    }
+
+    addMessageListener("embedui:resetView", resetView);
+})();
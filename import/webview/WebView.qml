@@ -20,7 +20,7 @@ import Sailfish.WebView.Pickers 1.0
 RawWebView {
     id: webview
 
-    property alias downloadsEnabled: popupOpener.downloadsEnabled
+    property bool downloadsEnabled
     property Page webViewPage: {
         var containerPage = _findParentWithProperty(webview, '__sailfish_webviewpage')
         if (!containerPage) containerPage = _findParentWithProperty(webview, '__silica_page')
@@ -33,12 +33,52 @@ RawWebView {
     property Item textSelectionController: null
     readonly property int _pageOrientation: webViewPage ? webViewPage.orientation : Orientation.None
     property int _contentOrientation: orientation
+    // Page orientation transitions start before the orientation changes,
+    // the last frame in the current orientation is captured then.
+    readonly property bool _orientationTransitionRunning: !!webViewPage && !!webViewPage.orientationTransitionRunning
+    // Orientation the snapshot was requested and taken in, -1 if none
+    property int _snapshotRequestOrientation: -1
+    property int _snapshotOrientation: -1
+    property bool _orientationSnapshotReady
     readonly property bool _appActive: Qt.application.state === Qt.ApplicationActive
     readonly property int _topCutoutInset: Math.max(0, Screen.topCutout.y + Screen.topCutout.height)
 
-    property alias popupProvider: popupOpener.popupProvider
-    property QtObject _textZoomController: TextZoomController {
-        webPage: webview
+    property PopupProvider popupProvider: PopupProvider {}
+
+    // Created on first use, see _openerMessageHandler.
+    property QtObject _pickerOpener
+    property QtObject _popupOpener
+    property Item _orientationDelayOverlay
+    property Item _busyIndicator
+
+    // Routes picker and popup messages to their opener, creating it first.
+    property QtObject _openerMessageHandler: QtObject {
+        function message(topic, data) {
+            if (PickerTopics.listeners.indexOf(topic) >= 0) {
+                if (!webview._pickerOpener) {
+                    webview._pickerOpener = pickerOpenerComponent.createObject(webview)
+                }
+                return webview._pickerOpener.message(topic, data)
+            }
+
+            if (!webview._popupOpener) {
+                webview._popupOpener = popupOpenerComponent.createObject(webview)
+            }
+            return webview._popupOpener.message(topic, data)
+        }
+    }
+
+    function _orientationAngle(orientation) {
+        switch (orientation) {
+        case Qt.LandscapeOrientation:
+            return 90
+        case Qt.InvertedPortraitOrientation:
+            return 180
+        case Qt.InvertedLandscapeOrientation:
+            return 270
+        default:
+            return 0
+        }
     }
 
     function _cutoutSafeAreaTop(orientation) {
@@ -81,9 +121,10 @@ RawWebView {
         }
     }
 
-    active: !webViewPage
-            || _appActive && (webViewPage.status === PageStatus.Active)
-            || _appActive && (webViewPage.status === PageStatus.Deactivating)
+    active: !pooled
+            && (!webViewPage
+                || _appActive && (webViewPage.status === PageStatus.Active)
+                || _appActive && (webViewPage.status === PageStatus.Deactivating))
     _acceptTouchEvents: !textSelectionActive
 
     viewportHeight: webViewPage ? height : undefined
@@ -92,8 +133,8 @@ RawWebView {
     safeAreaBottom: _cutoutSafeAreaBottom(_contentOrientation)
     safeAreaLeft: _cutoutSafeAreaLeft(_contentOrientation)
 
-    orientation: {
-        switch (_pageOrientation) {
+    function _screenOrientation(pageOrientation) {
+        switch (pageOrientation) {
         case Orientation.Portrait:
             return Qt.PortraitOrientation
         case Orientation.Landscape:
@@ -107,23 +148,92 @@ RawWebView {
         }
     }
 
-    onOrientationChanged: {
-        _contentOrientation = orientation
-        if (visible) {
-            orientationDelayOverlay.opacity = 1
+    // Applies the new orientation right away. If the last frame in the
+    // current orientation was captured ahead, the overlay shows it until
+    // the content has been rotated.
+    function _rotateTo(target) {
+        if (target !== orientation) {
+            _orientationSnapshotReady = snapshotUrl !== "" && _snapshotOrientation === orientation
+            orientation = target
+            _orientationSnapshotReady = false
         }
     }
 
-    onContentOrientationChanged: {
+    // Same as TextZoomController.textZoom
+    textZoom: Math.pow(Theme.fontSizeMedium / Theme.fontSizeMediumBase, 1.25)
+
+    on_PageOrientationChanged: _rotateTo(_screenOrientation(_pageOrientation))
+    on_OrientationTransitionRunningChanged: {
+        if (_orientationTransitionRunning) {
+            if (loaded && captureSnapshot(0.5)) {
+                _snapshotRequestOrientation = orientation
+            }
+        } else if (!rotating) {
+            // The transition did not change the orientation.
+            clearSnapshot()
+        }
+    }
+
+    onSnapshotUrlChanged: {
+        _snapshotOrientation = snapshotUrl !== "" ? _snapshotRequestOrientation : -1
+        _snapshotRequestOrientation = -1
+    }
+
+    onOrientationChanged: {
+        var previousOrientation = _contentOrientation
         _contentOrientation = orientation
-        orientationFadeOut.restart()
+        // RawWebView starts rotating before this handler runs.
+        if (rotating && _orientationSnapshotReady) {
+            if (!_orientationDelayOverlay) {
+                _orientationDelayOverlay = orientationDelayOverlayComponent.createObject(webview)
+            }
+            _orientationDelayOverlay.show(previousOrientation)
+        }
     }
 
-    onRecvAsyncMessage: {
-        if (pickerOpener.message(message, data) || popupOpener.message(message, data)) {
+    onContentOrientationChanged: _contentOrientation = orientation
+
+    onRotatingChanged: {
+        if (rotating) {
             return
         }
+        // The overlay clears the snapshot once it has faded out.
+        if (_orientationDelayOverlay && _orientationDelayOverlay.visible) {
+            _orientationDelayOverlay.fadeOut()
+        } else {
+            clearSnapshot()
+        }
+    }
 
+    // Back in WebViewPool, drop what the previous user left behind.
+    onPooledChanged: {
+        if (pooled) {
+            clearSelection()
+            if (_popupOpener) {
+                _popupOpener.reset()
+            }
+            if (_orientationDelayOverlay) {
+                _orientationDelayOverlay.hide()
+            }
+        }
+    }
+
+    onLoadingChanged: {
+        if (loading && !_busyIndicator) {
+            _busyIndicator = busyIndicatorComponent.createObject(webview)
+        }
+    }
+
+    onLoadedChanged: {
+        // Compile the popups in the background once per process.
+        if (loaded && !PopupComponentCache.preloaded) {
+            PopupComponentCache.preload(PopupTopics.componentUrls(popupProvider))
+        }
+    }
+
+    // Picker and popup messages are routed directly to _openerMessageHandler,
+    // see addMessageHandler() in Component.onCompleted.
+    onAsyncMessage: {
         switch(message) {
             case "embed:linkclicked": {
                 webview.linkClicked(data.uri)
@@ -175,72 +285,118 @@ RawWebView {
         }
     }
 
-    PickerOpener {
-        id: pickerOpener
+    Component {
+        id: pickerOpenerComponent
 
-        property QtObject pageStackOwner: webview._findParentWithProperty(webview, "pageStack")
+        PickerOpener {
+            property QtObject pageStackOwner: webview._findParentWithProperty(webview, "pageStack")
 
-        pageStack: pageStackOwner ? pageStackOwner.pageStack : undefined
-        contentItem: webview
+            pageStack: pageStackOwner ? pageStackOwner.pageStack : undefined
+            contentItem: webview
+        }
     }
 
-    PopupOpener {
-        id: popupOpener
+    Component {
+        id: popupOpenerComponent
 
-        pageStack: pickerOpener.pageStack
-        parentItem: webview.webViewPage || webview
-        contentItem: webview
-        downloadsEnabled: false
+        PopupOpener {
+            property QtObject pageStackOwner: webview._findParentWithProperty(webview, "pageStack")
 
-        onAboutToOpenPopup: webview.aboutToOpenPopup(topic, data)
-        onAboutToOpenContextMenu: {
-            if (Qt.inputMethod.visible) {
-                webview.parent.focus = true
-            }
+            pageStack: pageStackOwner ? pageStackOwner.pageStack : undefined
+            parentItem: webview.webViewPage || webview
+            contentItem: webview
+            popupProvider: webview.popupProvider
+            downloadsEnabled: webview.downloadsEnabled
+
+            onAboutToOpenPopup: webview.aboutToOpenPopup(topic, data)
+            onAboutToOpenContextMenu: {
+                if (Qt.inputMethod.visible) {
+                    webview.parent.focus = true
+                }
 
-            if (data.types.indexOf("content-text") !== -1) {
-                // we want to select some content text
-                webview.sendAsyncMessage("Browser:SelectionStart", {"xPos": data.xPos, "yPos": data.yPos})
+                if (data.types.indexOf("content-text") !== -1) {
+                    // we want to select some content text
+                    webview.sendAsyncMessage("Browser:SelectionStart", {"xPos": data.xPos, "yPos": data.yPos})
+                }
             }
         }
     }
 
-    Rectangle {
-        id: orientationDelayOverlay
+    Component {
+        id: orientationDelayOverlayComponent
 
-        width: webview.width
-        height: webview.height
+        // Shows the last frame before the rotation, rotated to the new
+        // orientation, until the content has been rendered in it.
+        Rectangle {
+            id: orientationDelayOverlay
 
-        opacity: 0
-        color: webview.backgroundColor
+            property int angle
 
-        NumberAnimation on opacity {
-            id: orientationFadeOut
+            function show(fromOrientation) {
+                angle = webview._orientationAngle(webview.orientation) - webview._orientationAngle(fromOrientation)
+                snapshot.source = webview.snapshotUrl
+                orientationFadeOut.stop()
+                opacity = 1
+            }
 
-            running: false
-            duration: 200
-            easing.type: Easing.InOutQuad
-            to: 0
-        }
-    }
+            function fadeOut() {
+                orientationFadeOut.restart()
+            }
+
+            function hide() {
+                orientationFadeOut.stop()
+                opacity = 0
+                snapshot.source = ""
+            }
 
-    Timer {
-        id: orientationDelayFailsafe
+            anchors.fill: parent
+            z: 1
+
+            opacity: 0
+            visible: opacity > 0
+            color: webview.backgroundColor
+
+            Image {
+                id: snapshot
+
+                anchors.centerIn: parent
+                width: parent.width
+                height: parent.height
+                cache: false
+                rotation: orientationDelayOverlay.angle
+                scale: orientationDelayOverlay.angle % 180 !== 0
+                       ? Math.min(parent.width / parent.height, parent.height / parent.width)
+                       : 1
+            }
 
-        running: !orientationFadeOut.running && orientationDelayOverlay.opacity === 1
-        onTriggered: {
-            orientationFadeOut.start()
+            NumberAnimation on opacity {
+                id: orientationFadeOut
+
+                running: false
+                duration: 200
+                easing.type: Easing.InOutQuad
+                to: 0
+                onStopped: {
+                    if (orientationDelayOverlay.opacity === 0) {
+                        snapshot.source = ""
+                        webview.clearSnapshot()
+                    }
+                }
+            }
         }
-        interval: 1000
     }
 
-    BusyIndicator {
-        x: (webview.viewportWidth - width) / 2
-        y: webview._indicatorVerticalOffset
-           + ((webview.viewportHeight - webview._indicatorVerticalOffset - height) / 2)
-        running: true
-        visible: webview.loading
-        size: BusyIndicatorSize.Large
+    Component {
+        id: busyIndicatorComponent
+
+        BusyIndicator {
+            x: (webview.viewportWidth - width) / 2
+            y: webview._indicatorVerticalOffset
+               + ((webview.viewportHeight - webview._indicatorVerticalOffset - height) / 2)
+            running: true
+            visible: webview.loading
+            size: BusyIndicatorSize.Large
+        }
     }
 
     SilicaPrivate.VirtualKeyboardObserver {
@@ -276,10 +432,17 @@ RawWebView {
     }
 
     Component.onCompleted: {
-        webview.addMessageListener("embed:linkclicked")
-        webview.addMessageListener("Content:ContextMenu")
-        webview.addMessageListener("Content:SelectionRange")
-        webview.addMessageListener("Content:SelectionCopied")
-        webview.addMessageListener("Content:SelectionSwap")
+        orientation = _screenOrientation(_pageOrientation)
+
+        webview.addMessageHandler(PickerTopics.listeners, _openerMessageHandler)
+        webview.addMessageHandler(PopupTopics.listeners, _openerMessageHandler)
+
+        // Only WebView handles these, plain RawWebViews don't listen to them.
+        webview.addMessageListeners(PickerTopics.listeners.concat(PopupTopics.listeners, [
+            "embed:linkclicked",
+            "Content:SelectionRange",
+            "Content:SelectionCopied",
+            "Content:SelectionSwap"
+        ]))
     }
 }
@@ -35,6 +35,7 @@ SilicaFlickable {
 
         y: headerLoader.implicitHeight
         _indicatorVerticalOffset: -y
+        _flickableEmbedded: true
         width: viewFlickable.width
         height: viewFlickable.contentHeight - headerLoader.implicitHeight
 
@@ -0,0 +1,363 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "clipboardbridge.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtGui/QClipboard>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QImage>
+#include <QtGui/QTextDocumentFragment>
+
+#include "webengine.h"
+
+// Rich text beyond this is a copy of a whole document rather than a
+// selection, keep only its plain text.
+#define DEFAULT_MAXIMUM_HTML_SIZE (4 * 1024 * 1024)
+// Longer plain text is cut, it would not be of use when pasted anyway.
+#define DEFAULT_MAXIMUM_TEXT_SIZE (16 * 1024 * 1024)
+// Small enough for a reply to not stall either process.
+#define DEFAULT_CHUNK_SIZE (256 * 1024)
+
+namespace SailfishOS {
+
+namespace WebView {
+
+struct ClipboardConversionReceiver
+{
+    QMutex mutex;
+    // Cleared when the bridge is destroyed
+    QObject *object = nullptr;
+};
+
+namespace {
+
+const auto MIME_TYPE_TEXT = QStringLiteral("text/plain");
+const auto MIME_TYPE_HTML = QStringLiteral("text/html");
+const auto MIME_TYPE_PNG = QStringLiteral("image/png");
+
+const auto CLIPBOARD_DATA = QStringLiteral("embedui:clipboard:data");
+
+// Converts clipboard contents to the form sent to Gecko in the thread pool.
+class ClipboardConversion : public QRunnable
+{
+public:
+    ClipboardConversion(const std::shared_ptr<ClipboardConversionReceiver> &receiver,
+                        uint serial, const QString &mimeType, const QVariant &source)
+        : m_receiver(receiver)
+        , m_serial(serial)
+        , m_mimeType(mimeType)
+        , m_source(source)
+    {
+    }
+
+    void run() override
+    {
+        QString data;
+        if (m_mimeType == MIME_TYPE_PNG) {
+            QByteArray png;
+            QBuffer buffer(&png);
+            buffer.open(QIODevice::WriteOnly);
+            m_source.value<QImage>().save(&buffer, "PNG");
+            data = QString::fromLatin1(png.toBase64());
+        } else {
+            data = QTextDocumentFragment::fromHtml(m_source.toString()).toPlainText();
+        }
+        m_source.clear();
+
+        QMutexLocker locker(&m_receiver->mutex);
+        if (m_receiver->object) {
+            QMetaObject::invokeMethod(m_receiver->object, "conversionFinished", Qt::QueuedConnection,
+                                      Q_ARG(uint, m_serial),
+                                      Q_ARG(QString, m_mimeType),
+                                      Q_ARG(QString, data));
+        }
+    }
+
+private:
+    std::shared_ptr<ClipboardConversionReceiver> m_receiver;
+    uint m_serial;
+    QString m_mimeType;
+    QVariant m_source;
+};
+
+}
+
+ClipboardMimeData::ClipboardMimeData(const QString &text, const QString &html, bool offerHtml, int maximumTextSize)
+    : m_text(text)
+    , m_textSource(text.isEmpty() ? html : QString())
+    , m_html(offerHtml ? html : QString())
+    , m_maximumTextSize(maximumTextSize)
+{
+}
+
+QStringList ClipboardMimeData::formats() const
+{
+    QStringList formats;
+    if (!m_text.isEmpty() || !m_textSource.isEmpty()) {
+        formats.append(MIME_TYPE_TEXT);
+    }
+    if (!m_html.isEmpty()) {
+        formats.append(MIME_TYPE_HTML);
+    }
+    return formats;
+}
+
+bool ClipboardMimeData::hasFormat(const QString &mimeType) const
+{
+    if (mimeType == MIME_TYPE_TEXT) {
+        return !m_text.isEmpty() || !m_textSource.isEmpty();
+    } else if (mimeType == MIME_TYPE_HTML) {
+        return !m_html.isEmpty();
+    }
+    return false;
+}
+
+QVariant ClipboardMimeData::retrieveData(const QString &mimeType, QVariant::Type type) const
+{
+    Q_UNUSED(type)
+
+    // QMimeData converts to the requested type.
+    if (mimeType == MIME_TYPE_TEXT) {
+        return plainText();
+    } else if (mimeType == MIME_TYPE_HTML && !m_html.isEmpty()) {
+        return m_html;
+    }
+    return QVariant();
+}
+
+QString ClipboardMimeData::textSource() const
+{
+    return m_textSource;
+}
+
+// Pastes into web views convert textSource() in the thread pool, this is
+// only reached by pastes of other clients.
+QString ClipboardMimeData::plainText() const
+{
+    if (!m_textSource.isEmpty()) {
+        // The text is never longer than its html, so the cut html bounds
+        // the conversion as well.
+        QString source;
+        source.swap(m_textSource);
+        source.truncate(m_maximumTextSize);
+        m_text = QTextDocumentFragment::fromHtml(source).toPlainText();
+    }
+
+    // Shares the data unless it is cut.
+    return m_text.left(m_maximumTextSize);
+}
+
+ClipboardBridge::ClipboardBridge(QObject *parent)
+    : QObject(parent)
+    , m_maximumHtmlSize(DEFAULT_MAXIMUM_HTML_SIZE)
+    , m_maximumTextSize(DEFAULT_MAXIMUM_TEXT_SIZE)
+    , m_chunkSize(DEFAULT_CHUNK_SIZE)
+    , m_serial(0)
+    , m_receiver(std::make_shared<ClipboardConversionReceiver>())
+{
+    m_receiver->object = this;
+    connect(QGuiApplication::clipboard(), &QClipboard::dataChanged,
+            this, &ClipboardBridge::clipboardChanged);
+}
+
+ClipboardBridge::~ClipboardBridge()
+{
+    // Conversions still running drop their result.
+    QMutexLocker locker(&m_receiver->mutex);
+    m_receiver->object = nullptr;
+}
+
+int ClipboardBridge::maximumHtmlSize() const
+{
+    return m_maximumHtmlSize;
+}
+
+void ClipboardBridge::setMaximumHtmlSize(int size)
+{
+    m_maximumHtmlSize = size;
+}
+
+int ClipboardBridge::maximumTextSize() const
+{
+    return m_maximumTextSize;
+}
+
+void ClipboardBridge::setMaximumTextSize(int size)
+{
+    m_maximumTextSize = qMax(0, size);
+}
+
+int ClipboardBridge::chunkSize() const
+{
+    return m_chunkSize;
+}
+
+void ClipboardBridge::setChunkSize(int size)
+{
+    m_chunkSize = qMax(1, size);
+}
+
+void ClipboardBridge::setData(const QVariant &data)
+{
+    const QVariantMap dataMap = data.toMap();
+
+    // check if we copied password
+    if (dataMap.value(QStringLiteral("private")).toBool()) {
+        return;
+    }
+
+    // Shallow copies of the strings Gecko sent.
+    const QString text = dataMap.value(QStringLiteral("data")).toString();
+    const QString html = dataMap.value(QStringLiteral("html")).toString();
+    if (text.isEmpty() && html.isEmpty()) {
+        QGuiApplication::clipboard()->clear();
+        return;
+    }
+
+    // The clipboard takes the ownership.
+    QGuiApplication::clipboard()->setMimeData(new ClipboardMimeData(text, html, html.size() <= m_maximumHtmlSize,
+                                                                          m_maximumTextSize));
+}
+
+void ClipboardBridge::getData(const QVariant &request)
+{
+    QVariantMap requestMap = request.toMap();
+    QStringList mimeTypes = requestMap.value(QStringLiteral("types")).toStringList();
+    if (mimeTypes.isEmpty()) {
+        mimeTypes.append(MIME_TYPE_TEXT);
+    }
+
+    // Chunks of an earlier clipboard are not mixed with the current one,
+    // a reply with the new serial tells Gecko to start over.
+    if (requestMap.contains(QStringLiteral("serial"))
+            && requestMap.value(QStringLiteral("serial")).toUInt() != m_serial) {
+        requestMap.insert(QStringLiteral("chunk"), 0);
+    }
+
+    const QString mimeType = negotiate(mimeTypes);
+    if (mimeType.isEmpty() || m_cache.contains(mimeType)) {
+        sendChunk(requestMap, mimeType);
+    } else if (m_pendingRequests.contains(mimeType)) {
+        m_pendingRequests[mimeType].append(requestMap);
+    } else if (convert(mimeType)) {
+        m_pendingRequests[mimeType].append(requestMap);
+    } else {
+        sendChunk(requestMap, mimeType);
+    }
+}
+
+void ClipboardBridge::clipboardChanged()
+{
+    ++m_serial;
+    m_cache.clear();
+
+    // Conversions of the old contents are dropped when they finish.
+    const QHash<QString, QList<QVariantMap>> pendingRequests = m_pendingRequests;
+    m_pendingRequests.clear();
+    for (const QList<QVariantMap> &requests : pendingRequests) {
+        for (const QVariantMap &request : requests) {
+            getData(request);
+        }
+    }
+}
+
+void ClipboardBridge::conversionFinished(uint serial, const QString &mimeType, const QString &data)
+{
+    if (serial != m_serial) {
+        return;
+    }
+
+    m_cache.insert(mimeType, data);
+    const QList<QVariantMap> requests = m_pendingRequests.take(mimeType);
+    for (const QVariantMap &request : requests) {
+        sendChunk(request, mimeType);
+    }
+}
+
+QString ClipboardBridge::negotiate(const QStringList &mimeTypes) const
+{
+    const QMimeData *mimeData = QGuiApplication::clipboard()->mimeData();
+    if (!mimeData) {
+        return QString();
+    }
+
+    for (const QString &mimeType : mimeTypes) {
+        if (m_cache.contains(mimeType)) {
+            return mimeType;
+        } else if (mimeType == MIME_TYPE_TEXT && (mimeData->hasText() || mimeData->hasHtml())) {
+            return mimeType;
+        } else if (mimeType == MIME_TYPE_HTML && mimeData->hasHtml()) {
+            return mimeType;
+        } else if (mimeType == MIME_TYPE_PNG && mimeData->hasImage()) {
+            return mimeType;
+        }
+    }
+    return QString();
+}
+
+// Caches the forms that need no conversion right away. Returns true if a
+// conversion was started, its requests are answered when it finishes.
+bool ClipboardBridge::convert(const QString &mimeType)
+{
+    const QMimeData *mimeData = QGuiApplication::clipboard()->mimeData();
+    if (!mimeData) {
+        return false;
+    }
+
+    QVariant source;
+    const ClipboardMimeData *clipboardData = dynamic_cast<const ClipboardMimeData *>(mimeData);
+    if (mimeType == MIME_TYPE_TEXT && clipboardData && !clipboardData->textSource().isEmpty()) {
+        // Html only copy of a web view, not converted yet.
+        source = clipboardData->textSource().left(m_maximumTextSize);
+    } else if (mimeType == MIME_TYPE_TEXT) {
+        const QString text = mimeData->text();
+        if (!text.isEmpty() || !mimeData->hasHtml()) {
+            m_cache.insert(mimeType, text.left(m_maximumTextSize));
+            return false;
+        }
+        source = mimeData->html();
+    } else if (mimeType == MIME_TYPE_HTML) {
+        m_cache.insert(mimeType, mimeData->html());
+        return false;
+    } else if (mimeType == MIME_TYPE_PNG) {
+        source = mimeData->imageData();
+    } else {
+        return false;
+    }
+
+    QThreadPool::globalInstance()->start(new ClipboardConversion(m_receiver, m_serial, mimeType, source));
+    return true;
+}
+
+void ClipboardBridge::sendChunk(const QVariantMap &request, const QString &mimeType)
+{
+    const QString data = m_cache.value(mimeType);
+    const int chunkCount = qMax(1, (data.size() + m_chunkSize - 1) / m_chunkSize);
+    const int chunk = qBound(0, request.value(QStringLiteral("chunk")).toInt(), chunkCount - 1);
+
+    QVariantMap reply;
+    reply.insert(QStringLiteral("id"), request.value(QStringLiteral("id")));
+    reply.insert(QStringLiteral("serial"), m_serial);
+    reply.insert(QStringLiteral("type"), mimeType);
+    reply.insert(QStringLiteral("size"), data.size());
+    reply.insert(QStringLiteral("chunk"), chunk);
+    reply.insert(QStringLiteral("chunkCount"), chunkCount);
+    reply.insert(QStringLiteral("data"), data.mid(chunk * m_chunkSize, m_chunkSize));
+    SailfishOS::WebEngine::instance()->notifyObservers(CLIPBOARD_DATA, QVariant(reply));
+}
+
+} // namespace WebView
+
+} // namespace SailfishOS
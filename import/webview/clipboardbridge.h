@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_WEBVIEW_CLIPBOARDBRIDGE_H
+#define SAILFISHOS_WEBVIEW_CLIPBOARDBRIDGE_H
+
+#include <QtCore/QHash>
+#include <QtCore/QMimeData>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QVariant>
+
+#include <memory>
+
+namespace SailfishOS {
+
+namespace WebView {
+
+struct ClipboardConversionReceiver;
+
+// Clipboard contents copied from web content. Nothing is converted when
+// the data is set, the formats are produced when a paste asks for them.
+// The plain text of an html only copy is converted on its first paste,
+// plain text is cut to maximumTextSize characters.
+class ClipboardMimeData : public QMimeData
+{
+public:
+    ClipboardMimeData(const QString &text, const QString &html, bool offerHtml, int maximumTextSize);
+
+    QStringList formats() const override;
+    bool hasFormat(const QString &mimeType) const override;
+
+    // Html the plain text is still to be converted from, empty if it was
+    // copied as plain text or has been converted already.
+    QString textSource() const;
+
+protected:
+    QVariant retrieveData(const QString &mimeType, QVariant::Type type) const override;
+
+private:
+    QString plainText() const;
+
+    mutable QString m_text;
+    mutable QString m_textSource;
+    QString m_html;
+    int m_maximumTextSize;
+};
+
+// Moves clipboard:setdata payloads from Gecko to the system clipboard and
+// answers clipboard:getdata requests with the system clipboard contents.
+class ClipboardBridge : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ClipboardBridge(QObject *parent = nullptr);
+    ~ClipboardBridge();
+
+    // Characters, larger copies are only offered as plain text.
+    int maximumHtmlSize() const;
+    void setMaximumHtmlSize(int size);
+
+    // Characters, plain text of larger copies is cut to this size.
+    int maximumTextSize() const;
+    void setMaximumTextSize(int size);
+
+    // Characters of data in one embedui:clipboard:data reply.
+    int chunkSize() const;
+    void setChunkSize(int size);
+
+    // Handles a clipboard:setdata payload. Copies marked private, such as
+    // passwords, are not put to the clipboard.
+    void setData(const QVariant &data);
+
+    // Handles a clipboard:getdata request. The request lists the accepted
+    // mime types in the order of preference and the chunk to send.
+    void getData(const QVariant &request);
+
+private slots:
+    void clipboardChanged();
+    void conversionFinished(uint serial, const QString &mimeType, const QString &data);
+
+private:
+    QString negotiate(const QStringList &mimeTypes) const;
+    bool convert(const QString &mimeType);
+    void sendChunk(const QVariantMap &request, const QString &mimeType);
+
+    int m_maximumHtmlSize;
+    int m_maximumTextSize;
+    int m_chunkSize;
+    // Increased whenever the clipboard changes.
+    uint m_serial;
+    // Clipboard contents in the form sent to Gecko, by mime type.
+    QHash<QString, QString> m_cache;
+    QHash<QString, QList<QVariantMap>> m_pendingRequests;
+    // Shared with the conversions, which may finish after the bridge is gone
+    std::shared_ptr<ClipboardConversionReceiver> m_receiver;
+};
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#endif // SAILFISHOS_WEBVIEW_CLIPBOARDBRIDGE_H
@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "framestatistics.h"
+
+#include <QtCore/QVariantList>
+
+namespace SailfishOS {
+
+namespace WebView {
+
+const qint64 FrameStatistics::IdleInterval;
+
+FrameStatistics::FrameStatistics(qreal refreshRate)
+{
+    setRefreshRate(refreshRate);
+    reset();
+}
+
+qreal FrameStatistics::refreshRate() const
+{
+    return 1000000000.0 / m_refreshInterval;
+}
+
+void FrameStatistics::setRefreshRate(qreal refreshRate)
+{
+    m_refreshInterval = qRound64(1000000000.0 / (refreshRate > 0.0 ? refreshRate : 60.0));
+}
+
+void FrameStatistics::addFrame(qint64 timestamp, bool contentPending)
+{
+    const qint64 previousFrame = m_previousFrame;
+    m_previousFrame = timestamp;
+    ++m_frames;
+
+    if (previousFrame < 0) {
+        return;
+    }
+
+    const qint64 interval = timestamp - previousFrame;
+    if (interval <= 0 || interval > IdleInterval) {
+        return;
+    }
+
+    ++m_intervals;
+    m_totalInterval += interval;
+    m_maximumInterval = qMax(m_maximumInterval, interval);
+
+    // Half a refresh interval of slack for vsync jitter.
+    const int missedFrames = qMax<qint64>(0, (interval + m_refreshInterval / 2) / m_refreshInterval - 1);
+    m_droppedFrames += missedFrames;
+    ++m_histogram[bucket(missedFrames)];
+
+    if (contentPending) {
+        m_checkerboardTime += interval;
+    }
+}
+
+// The next frame has no interval before it.
+void FrameStatistics::interrupt()
+{
+    m_previousFrame = -1;
+}
+
+void FrameStatistics::reset()
+{
+    m_previousFrame = -1;
+    m_frames = 0;
+    m_intervals = 0;
+    m_droppedFrames = 0;
+    m_totalInterval = 0;
+    m_maximumInterval = 0;
+    m_checkerboardTime = 0;
+    for (int i = 0; i < HistogramBuckets; ++i) {
+        m_histogram[i] = 0;
+    }
+}
+
+quint64 FrameStatistics::frames() const
+{
+    return m_frames;
+}
+
+quint64 FrameStatistics::droppedFrames() const
+{
+    return m_droppedFrames;
+}
+
+qint64 FrameStatistics::averageInterval() const
+{
+    return m_intervals > 0 ? m_totalInterval / qint64(m_intervals) : 0;
+}
+
+qint64 FrameStatistics::maximumInterval() const
+{
+    return m_maximumInterval;
+}
+
+qint64 FrameStatistics::checkerboardTime() const
+{
+    return m_checkerboardTime;
+}
+
+quint64 FrameStatistics::histogram(int bucket) const
+{
+    return bucket >= 0 && bucket < HistogramBuckets ? m_histogram[bucket] : 0;
+}
+
+QVariantMap FrameStatistics::toVariantMap() const
+{
+    QVariantList histogram;
+    for (int i = 0; i < HistogramBuckets; ++i) {
+        histogram.append(m_histogram[i]);
+    }
+
+    QVariantMap statistics;
+    statistics.insert(QStringLiteral("frames"), m_frames);
+    statistics.insert(QStringLiteral("droppedFrames"), m_droppedFrames);
+    statistics.insert(QStringLiteral("averageFrameInterval"), averageInterval() / 1000000.0);
+    statistics.insert(QStringLiteral("maximumFrameInterval"), m_maximumInterval / 1000000.0);
+    statistics.insert(QStringLiteral("checkerboardTime"), m_checkerboardTime / 1000000.0);
+    statistics.insert(QStringLiteral("jankHistogram"), histogram);
+    return statistics;
+}
+
+int FrameStatistics::bucket(int missedFrames)
+{
+    if (missedFrames <= 0) {
+        return 0;
+    } else if (missedFrames == 1) {
+        return 1;
+    } else if (missedFrames < 4) {
+        return 2;
+    } else if (missedFrames < 8) {
+        return 3;
+    }
+    return 4;
+}
+
+} // namespace WebView
+
+} // namespace SailfishOS
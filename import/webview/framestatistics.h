@@ -0,0 +1,75 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_WEBVIEW_FRAMESTATISTICS_H
+#define SAILFISHOS_WEBVIEW_FRAMESTATISTICS_H
+
+#include <QtCore/QVariantMap>
+
+namespace SailfishOS {
+
+namespace WebView {
+
+// Frame timing of a view from the presentation times of its window.
+// Times are in nanoseconds. Frames are only expected back to back while
+// something moves, the recorder interrupts the sequence when the motion
+// ends, so that the next frame starts a new one. A gap longer than
+// IdleInterval within a sequence also means the window had nothing to
+// render instead of a long frame.
+class FrameStatistics
+{
+public:
+    enum {
+        // Frames missed: 0, 1, 2-3, 4-7 and 8 or more.
+        HistogramBuckets = 5
+    };
+
+    static const qint64 IdleInterval = 250000000;
+
+    explicit FrameStatistics(qreal refreshRate = 60.0);
+
+    qreal refreshRate() const;
+    void setRefreshRate(qreal refreshRate);
+
+    // contentPending is true when the view showed no up to date content,
+    // e.g. before the first paint, the interval counts as checkerboarding.
+    void addFrame(qint64 timestamp, bool contentPending = false);
+    void interrupt();
+    void reset();
+
+    quint64 frames() const;
+    quint64 droppedFrames() const;
+    qint64 averageInterval() const;
+    qint64 maximumInterval() const;
+    qint64 checkerboardTime() const;
+    quint64 histogram(int bucket) const;
+
+    // Milliseconds, as exposed to QML.
+    QVariantMap toVariantMap() const;
+
+    static int bucket(int missedFrames);
+
+private:
+    qint64 m_refreshInterval;
+    qint64 m_previousFrame;
+    quint64 m_frames;
+    quint64 m_intervals;
+    quint64 m_droppedFrames;
+    qint64 m_totalInterval;
+    qint64 m_maximumInterval;
+    qint64 m_checkerboardTime;
+    quint64 m_histogram[HistogramBuckets];
+};
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#endif // SAILFISHOS_WEBVIEW_FRAMESTATISTICS_H
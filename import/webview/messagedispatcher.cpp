@@ -0,0 +1,199 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "messagedispatcher.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMetaObject>
+
+#include "logging.h"
+
+namespace SailfishOS {
+
+namespace WebView {
+
+void MessageDispatcher::addHandler(const QString &topic, const Handler &handler)
+{
+    Entry entry;
+    entry.handler = handler;
+    m_handlers[topic].append(entry);
+}
+
+void MessageDispatcher::addHandler(const QString &topic, QObject *handler)
+{
+    if (!handler) {
+        return;
+    }
+
+    QVector<Entry> &entries = m_handlers[topic];
+    for (const Entry &entry : entries) {
+        if (entry.isObject && entry.object == handler) {
+            return;
+        }
+    }
+
+    Entry entry;
+    entry.object = handler;
+    entry.isObject = true;
+    entries.append(entry);
+}
+
+void MessageDispatcher::removeHandler(QObject *handler)
+{
+    for (auto it = m_handlers.begin(); it != m_handlers.end();) {
+        QVector<Entry> &entries = it.value();
+        for (int i = entries.count() - 1; i >= 0; --i) {
+            if (entries.at(i).isObject && (!entries.at(i).object || entries.at(i).object == handler)) {
+                entries.remove(i);
+            }
+        }
+
+        if (entries.isEmpty()) {
+            it = m_handlers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MessageDispatcher::setFallback(const Handler &fallback)
+{
+    m_fallback = fallback;
+}
+
+bool MessageDispatcher::dispatch(const QString &topic, const QVariant &data)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    bool handled = false;
+    qint64 qmlHandlerTime = 0;
+    auto it = m_handlers.constFind(topic);
+    if (it != m_handlers.constEnd()) {
+        // Copy, a handler may register or remove handlers. Like the chain
+        // in WebView.qml, the first handler that takes the message ends it.
+        const QVector<Entry> entries = it.value();
+        for (const Entry &entry : entries) {
+            if (entry.isObject) {
+                const qint64 start = timer.nsecsElapsed();
+                handled = invoke(entry, topic, data);
+                qmlHandlerTime += timer.nsecsElapsed() - start;
+            } else {
+                handled = invoke(entry, topic, data);
+            }
+            if (handled) {
+                break;
+            }
+        }
+    }
+
+    if (!handled && m_fallback) {
+        const qint64 start = timer.nsecsElapsed();
+        handled = m_fallback(topic, data);
+        qmlHandlerTime += timer.nsecsElapsed() - start;
+    }
+
+    const qint64 handlerTime = timer.nsecsElapsed();
+    TopicStatistics &statistics = m_statistics[topic];
+    ++statistics.count;
+    statistics.handlerTime += handlerTime;
+    statistics.maxHandlerTime = qMax(statistics.maxHandlerTime, handlerTime);
+    if (m_instrumentationEnabled) {
+        statistics.qmlHandlerTime += qmlHandlerTime;
+        statistics.payloadSize += estimatePayloadSize(data);
+    }
+
+    return handled;
+}
+
+bool MessageDispatcher::instrumentationEnabled() const
+{
+    return m_instrumentationEnabled;
+}
+
+void MessageDispatcher::setInstrumentationEnabled(bool enabled)
+{
+    m_instrumentationEnabled = enabled;
+}
+
+QHash<QString, MessageDispatcher::TopicStatistics> MessageDispatcher::statistics() const
+{
+    return m_statistics;
+}
+
+void MessageDispatcher::resetStatistics()
+{
+    m_statistics.clear();
+}
+
+// Rough size of the payload as it was serialized by Gecko.
+quint64 MessageDispatcher::estimatePayloadSize(const QVariant &data)
+{
+    switch (static_cast<int>(data.type())) {
+    case QMetaType::QVariantMap: {
+        quint64 size = 0;
+        const QVariantMap map = data.toMap();
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            size += it.key().size() + estimatePayloadSize(it.value());
+        }
+        return size;
+    }
+    case QMetaType::QVariantList: {
+        quint64 size = 0;
+        const QVariantList list = data.toList();
+        for (const QVariant &value : list) {
+            size += estimatePayloadSize(value);
+        }
+        return size;
+    }
+    case QMetaType::QString:
+        return data.toString().size();
+    case QMetaType::QByteArray:
+        return data.toByteArray().size();
+    case QMetaType::QStringList: {
+        quint64 size = 0;
+        const QStringList list = data.toStringList();
+        for (const QString &value : list) {
+            size += value.size();
+        }
+        return size;
+    }
+    case QMetaType::UnknownType:
+        return 0;
+    default:
+        return sizeof(double);
+    }
+}
+
+bool MessageDispatcher::invoke(const Entry &entry, const QString &topic, const QVariant &data) const
+{
+    if (!entry.isObject) {
+        return entry.handler(topic, data);
+    }
+
+    if (!entry.object) {
+        return false;
+    }
+
+    QVariant handled;
+    if (!QMetaObject::invokeMethod(entry.object, "message",
+                                   Q_RETURN_ARG(QVariant, handled),
+                                   Q_ARG(QVariant, topic),
+                                   Q_ARG(QVariant, data))) {
+        qCWarning(lcWebviewLog) << "Message handler" << entry.object << "has no message(topic, data) method";
+        return false;
+    }
+
+    return handled.toBool();
+}
+
+} // namespace WebView
+
+} // namespace SailfishOS
@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_WEBVIEW_MESSAGEDISPATCHER_H
+#define SAILFISHOS_WEBVIEW_MESSAGEDISPATCHER_H
+
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+#include <functional>
+
+namespace SailfishOS {
+
+namespace WebView {
+
+// Routes async messages of a view to the handlers registered for their topic.
+// Handlers are called in registration order until one of them handles the
+// message. Messages consumed by a native handler are never converted to JS
+// values.
+class MessageDispatcher
+{
+public:
+    // Returns true if the message was handled.
+    typedef std::function<bool(const QString &topic, const QVariant &data)> Handler;
+
+    // Times are in nanoseconds. Payload size and QML handler time are only
+    // collected when instrumentation is enabled.
+    struct TopicStatistics
+    {
+        quint64 count = 0;
+        qint64 handlerTime = 0;
+        qint64 maxHandlerTime = 0;
+        qint64 qmlHandlerTime = 0;
+        quint64 payloadSize = 0;
+    };
+
+    void addHandler(const QString &topic, const Handler &handler);
+    // The handler object must have a message(topic, data) method returning
+    // true when the message is handled, e.g. PopupOpener and PickerOpener.
+    void addHandler(const QString &topic, QObject *handler);
+    void removeHandler(QObject *handler);
+
+    // Called for messages that no registered handler consumed.
+    void setFallback(const Handler &fallback);
+
+    bool dispatch(const QString &topic, const QVariant &data);
+
+    bool instrumentationEnabled() const;
+    void setInstrumentationEnabled(bool enabled);
+
+    QHash<QString, TopicStatistics> statistics() const;
+    void resetStatistics();
+
+    static quint64 estimatePayloadSize(const QVariant &data);
+
+private:
+    struct Entry
+    {
+        Handler handler;
+        QPointer<QObject> object;
+        bool isObject = false;
+    };
+
+    bool invoke(const Entry &entry, const QString &topic, const QVariant &data) const;
+
+    QHash<QString, QVector<Entry>> m_handlers;
+    QHash<QString, TopicStatistics> m_statistics;
+    Handler m_fallback;
+    bool m_instrumentationEnabled = false;
+};
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#endif // SAILFISHOS_WEBVIEW_MESSAGEDISPATCHER_H
@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "messagestatisticsmodel.h"
+
+namespace SailfishOS {
+
+namespace WebView {
+
+static qreal toMilliseconds(qint64 nanoseconds)
+{
+    return nanoseconds / 1000000.0;
+}
+
+MessageStatisticsModel::MessageStatisticsModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+// Topics keep the order they were first seen in so that views do not jump.
+void MessageStatisticsModel::setStatistics(const QHash<QString, MessageDispatcher::TopicStatistics> &statistics)
+{
+    const int previousCount = m_topics.count();
+    QHash<QString, MessageDispatcher::TopicStatistics> remaining = statistics;
+
+    for (int i = m_topics.count() - 1; i >= 0; --i) {
+        if (!remaining.contains(m_topics.at(i).first)) {
+            beginRemoveRows(QModelIndex(), i, i);
+            m_topics.remove(i);
+            endRemoveRows();
+        }
+    }
+
+    for (int i = 0; i < m_topics.count(); ++i) {
+        m_topics[i].second = remaining.take(m_topics.at(i).first);
+    }
+    if (!m_topics.isEmpty()) {
+        emit dataChanged(index(0), index(m_topics.count() - 1));
+    }
+
+    if (!remaining.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_topics.count(), m_topics.count() + remaining.count() - 1);
+        for (auto it = remaining.constBegin(); it != remaining.constEnd(); ++it) {
+            m_topics.append(qMakePair(it.key(), it.value()));
+        }
+        endInsertRows();
+    }
+
+    if (m_topics.count() != previousCount) {
+        emit countChanged();
+    }
+}
+
+QVariant MessageStatisticsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_topics.count())
+        return QVariant();
+
+    const MessageDispatcher::TopicStatistics &statistics = m_topics.at(index.row()).second;
+    switch (role) {
+    case Topic:
+        return m_topics.at(index.row()).first;
+    case Count:
+        return statistics.count;
+    case PayloadSize:
+        return statistics.payloadSize;
+    case HandlerTime:
+        return toMilliseconds(statistics.handlerTime);
+    case MaxHandlerTime:
+        return toMilliseconds(statistics.maxHandlerTime);
+    case QmlHandlerTime:
+        return toMilliseconds(statistics.qmlHandlerTime);
+    default:
+        return QVariant();
+    }
+}
+
+int MessageStatisticsModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return m_topics.count();
+}
+
+QHash<int, QByteArray> MessageStatisticsModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[Topic] = "topic";
+    roles[Count] = "count";
+    roles[PayloadSize] = "payloadSize";
+    roles[HandlerTime] = "handlerTime";
+    roles[MaxHandlerTime] = "maxHandlerTime";
+    roles[QmlHandlerTime] = "qmlHandlerTime";
+    return roles;
+}
+
+} // namespace WebView
+
+} // namespace SailfishOS
@@ -0,0 +1,60 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_WEBVIEW_MESSAGESTATISTICSMODEL_H
+#define SAILFISHOS_WEBVIEW_MESSAGESTATISTICSMODEL_H
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QPair>
+#include <QtCore/QVector>
+
+#include "messagedispatcher.h"
+
+namespace SailfishOS {
+
+namespace WebView {
+
+// Per topic async message statistics of a RawWebView. Times are reported
+// in milliseconds and sizes in bytes.
+class MessageStatisticsModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        Topic = Qt::UserRole,
+        Count,
+        PayloadSize,
+        HandlerTime,
+        MaxHandlerTime,
+        QmlHandlerTime
+    };
+
+    MessageStatisticsModel(QObject *parent = nullptr);
+
+    void setStatistics(const QHash<QString, MessageDispatcher::TopicStatistics> &statistics);
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void countChanged();
+
+private:
+    QVector<QPair<QString, MessageDispatcher::TopicStatistics>> m_topics;
+};
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#endif // SAILFISHOS_WEBVIEW_MESSAGESTATISTICSMODEL_H
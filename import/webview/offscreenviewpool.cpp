@@ -0,0 +1,742 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "offscreenviewpool.h"
+#include "rawwebview.h"
+#include "snapshotcache.h"
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFramebufferObject>
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/QScreen>
+#include <QtQuick/QQuickRenderControl>
+#include <QtQuick/QQuickWindow>
+
+#include "logging.h"
+
+#include <climits>
+
+#define DEFAULT_SETTLE_TIME 500
+#define DEFAULT_TIMEOUT 20000
+// Offscreen views are destroyed when they have had nothing to do for this long.
+#define IDLE_TIMEOUT 30000
+// Longest wait for a frame of the visible windows before rendering anyway.
+#define FOREGROUND_FRAME_TIMEOUT 32
+// Keeps the snapshots of offscreen requests apart from those of views.
+#define SNAPSHOT_KEY_FLAG 0x80000000u
+
+namespace SailfishOS {
+
+namespace WebView {
+
+// Owns the OpenGL resources of an OffscreenView. Lives on the render
+// thread of the pool, where the scene is synchronized, rendered and read
+// back, so that none of it stalls the GUI thread.
+class OffscreenRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    OffscreenRenderer(QOffscreenSurface *surface, QQuickRenderControl *renderControl, QQuickWindow *window);
+
+    QOpenGLContext *context() const;
+
+    // The GUI thread waits for the scene to be synchronized.
+    QMutex mutex;
+    QWaitCondition synchronized;
+
+public slots:
+    bool initialize();
+    void render(QObject *receiver, int requestId, const QSize &viewportSize, const QSize &size);
+    void cleanup();
+
+private:
+    bool resize(const QSize &size);
+    QImage grab(const QSize &size);
+
+    QOpenGLContext *m_context;
+    QOffscreenSurface *m_surface;
+    QQuickRenderControl *m_renderControl;
+    QQuickWindow *m_window;
+    QScopedPointer<QOpenGLFramebufferObject> m_framebuffer;
+};
+
+OffscreenRenderer::OffscreenRenderer(QOffscreenSurface *surface, QQuickRenderControl *renderControl, QQuickWindow *window)
+    : m_context(new QOpenGLContext(this))
+    , m_surface(surface)
+    , m_renderControl(renderControl)
+    , m_window(window)
+{
+    m_context->setShareContext(QOpenGLContext::globalShareContext());
+}
+
+QOpenGLContext *OffscreenRenderer::context() const
+{
+    return m_context;
+}
+
+bool OffscreenRenderer::initialize()
+{
+    if (!m_context->makeCurrent(m_surface)) {
+        return false;
+    }
+    m_renderControl->initialize(m_context);
+    m_context->doneCurrent();
+    return true;
+}
+
+// Called with the context current while the GUI thread is blocked.
+bool OffscreenRenderer::resize(const QSize &size)
+{
+    if (!m_framebuffer || m_framebuffer->size() != size) {
+        m_framebuffer.reset(new QOpenGLFramebufferObject(size, QOpenGLFramebufferObject::CombinedDepthStencil));
+        m_window->setRenderTarget(m_framebuffer.data());
+    }
+    return m_framebuffer->isValid();
+}
+
+// The framebuffer is sized and the scene synchronized while the GUI thread
+// waits, then the scene is rendered and, for a request id other than -1,
+// read back while the GUI thread goes on. A frame that can't be rendered
+// delivers a null snapshot.
+void OffscreenRenderer::render(QObject *receiver, int requestId, const QSize &viewportSize, const QSize &size)
+{
+    QMutexLocker locker(&mutex);
+    const bool current = m_context->makeCurrent(m_surface);
+    const bool ready = current && resize(viewportSize);
+    if (ready) {
+        m_renderControl->sync();
+    }
+    synchronized.wakeOne();
+    locker.unlock();
+
+    QImage snapshot;
+    if (ready) {
+        m_renderControl->render();
+        if (requestId != -1) {
+            snapshot = grab(size);
+        }
+        m_window->resetOpenGLState();
+        m_context->functions()->glFlush();
+    }
+    if (current) {
+        m_context->doneCurrent();
+    }
+
+    // The receiver waits for cleanup() before it is destroyed, which
+    // discards this call if it is still posted.
+    QMetaObject::invokeMethod(receiver, "rendered", Qt::QueuedConnection,
+                              Q_ARG(int, requestId), Q_ARG(QImage, snapshot));
+}
+
+void OffscreenRenderer::cleanup()
+{
+    if (m_context->makeCurrent(m_surface)) {
+        m_framebuffer.reset();
+        m_renderControl->invalidate();
+        m_context->doneCurrent();
+    }
+}
+
+// The top of the page, in the aspect ratio of the requested size, is
+// downscaled on the GPU when possible so that only the snapshot itself
+// is read back.
+QImage OffscreenRenderer::grab(const QSize &size)
+{
+    const QSize framebufferSize = m_framebuffer->size();
+    const int sourceHeight = qMin(framebufferSize.height(),
+                                  qRound(qreal(framebufferSize.width()) * size.height() / size.width()));
+    // OpenGL framebuffer coordinates grow upwards.
+    const QRect sourceRect(0, framebufferSize.height() - sourceHeight, framebufferSize.width(), sourceHeight);
+
+    if (QOpenGLFramebufferObject::hasOpenGLFramebufferBlit()) {
+        QOpenGLFramebufferObject target(size);
+        QOpenGLFramebufferObject::blitFramebuffer(&target, QRect(QPoint(), size),
+                                                  m_framebuffer.data(), sourceRect,
+                                                  GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        return target.toImage();
+    }
+
+    return m_framebuffer->toImage()
+            .copy(0, 0, sourceRect.width(), sourceRect.height())
+            .scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+// A RawWebView in a window of its own that is rendered on demand into a
+// framebuffer object on the render thread of the pool.
+class OffscreenView : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OffscreenView(OffscreenViewPool *pool);
+    ~OffscreenView();
+
+    bool isValid() const;
+    bool busy() const;
+    int requestId() const;
+
+    void start(const OffscreenViewPool::Request &request, const QSize &viewportSize, int timeout);
+    void cancel();
+    bool render();
+
+private slots:
+    void loadingChanged();
+    void sceneChanged();
+    void capture();
+    void timedOut();
+    void viewDestroyed();
+    void rendered(int requestId, const QImage &snapshot);
+
+private:
+    void finish(const QImage &snapshot);
+
+    OffscreenViewPool *m_pool;
+    QOffscreenSurface m_surface;
+    QQuickRenderControl m_renderControl;
+    QQuickWindow *m_window;
+    OffscreenRenderer *m_renderer;
+    QPointer<RawWebView> m_view;
+    QTimer m_settleTimer;
+    QTimer m_timeoutTimer;
+    QTimer m_idleTimer;
+    OffscreenViewPool::Request m_request;
+    QSize m_viewportSize;
+    bool m_busy;
+    bool m_captureRequested;
+    // A frame of the view is being rendered on the render thread
+    bool m_rendering;
+    bool m_initialized;
+};
+
+OffscreenView::OffscreenView(OffscreenViewPool *pool)
+    : QObject(pool)
+    , m_pool(pool)
+    , m_window(nullptr)
+    , m_renderer(nullptr)
+    , m_busy(false)
+    , m_captureRequested(false)
+    , m_rendering(false)
+    , m_initialized(false)
+{
+    m_window = new QQuickWindow(&m_renderControl);
+    m_renderer = new OffscreenRenderer(&m_surface, &m_renderControl, m_window);
+    if (!m_renderer->context()->create()) {
+        qCWarning(lcWebviewLog) << "Cannot create OpenGL context for an offscreen view";
+        return;
+    }
+    // Created on the GUI thread, used on the render thread.
+    m_surface.setFormat(m_renderer->context()->format());
+    m_surface.create();
+
+    QThread *renderThread = pool->renderThread();
+    m_renderer->moveToThread(renderThread);
+    m_renderControl.prepareThread(renderThread);
+    QMetaObject::invokeMethod(m_renderer, "initialize", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, m_initialized));
+    if (!m_initialized) {
+        return;
+    }
+
+    m_view = new RawWebView(m_window->contentItem());
+    connect(m_view.data(), &QuickMozView::loadingChanged, this, &OffscreenView::loadingChanged);
+    connect(m_view.data(), &QObject::destroyed, this, &OffscreenView::viewDestroyed);
+
+    connect(&m_renderControl, &QQuickRenderControl::renderRequested, this, &OffscreenView::sceneChanged);
+    connect(&m_renderControl, &QQuickRenderControl::sceneChanged, this, &OffscreenView::sceneChanged);
+
+    m_settleTimer.setSingleShot(true);
+    connect(&m_settleTimer, &QTimer::timeout, this, &OffscreenView::capture);
+    m_timeoutTimer.setSingleShot(true);
+    connect(&m_timeoutTimer, &QTimer::timeout, this, &OffscreenView::timedOut);
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(IDLE_TIMEOUT);
+    connect(&m_idleTimer, &QTimer::timeout, this, [this]() {
+        m_pool->viewIdle(this);
+    });
+}
+
+OffscreenView::~OffscreenView()
+{
+    if (m_view) {
+        disconnect(m_view.data(), nullptr, this, nullptr);
+        delete m_view.data();
+    }
+
+    // The render thread is freed for the other views right away, as the
+    // frame in progress would not be posted back.
+    if (m_rendering) {
+        m_pool->viewRendered();
+    }
+
+    // Waits for a frame in progress, nothing is posted back afterwards.
+    if (m_renderer->thread() != thread()) {
+        if (m_initialized) {
+            QMetaObject::invokeMethod(m_renderer, "cleanup", Qt::BlockingQueuedConnection);
+        }
+        m_renderer->deleteLater();
+    } else {
+        delete m_renderer;
+    }
+    delete m_window;
+}
+
+bool OffscreenView::isValid() const
+{
+    return m_view;
+}
+
+bool OffscreenView::busy() const
+{
+    return m_busy;
+}
+
+int OffscreenView::requestId() const
+{
+    return m_busy ? m_request.id : -1;
+}
+
+// The framebuffer is sized by the first frame on the render thread. If it
+// can't be created, the capture delivers a null snapshot and the request
+// fails from there.
+void OffscreenView::start(const OffscreenViewPool::Request &request, const QSize &viewportSize, int timeout)
+{
+    m_request = request;
+    m_viewportSize = viewportSize;
+    m_busy = true;
+    m_captureRequested = false;
+    m_idleTimer.stop();
+
+    m_window->setGeometry(QRect(QPoint(), viewportSize));
+    m_view->setSize(viewportSize);
+    m_view->setActive(true);
+    m_view->load(request.url.toString());
+    m_timeoutTimer.start(timeout);
+}
+
+void OffscreenView::cancel()
+{
+    if (m_busy) {
+        m_busy = false;
+        m_settleTimer.stop();
+        m_timeoutTimer.stop();
+        if (m_view) {
+            m_view->stop();
+            m_view->setActive(false);
+        }
+        m_idleTimer.start();
+    }
+}
+
+// Called by the pool, at most once per frame of the visible windows and
+// only while the render thread has no other frame, so that it picks this
+// one up right away. Only the polish and the synchronization of the scene
+// run on the GUI thread. Returns false if no frame was started.
+bool OffscreenView::render()
+{
+    if (!m_view) {
+        return false;
+    }
+
+    m_renderControl.polishItems();
+
+    const int requestId = m_captureRequested && m_busy ? m_request.id : -1;
+    QMutexLocker locker(&m_renderer->mutex);
+    m_rendering = true;
+    QMetaObject::invokeMethod(m_renderer, "render", Qt::QueuedConnection,
+                              Q_ARG(QObject *, this), Q_ARG(int, requestId),
+                              Q_ARG(QSize, m_viewportSize), Q_ARG(QSize, m_request.size));
+    m_renderer->synchronized.wait(&m_renderer->mutex);
+    return true;
+}
+
+void OffscreenView::rendered(int requestId, const QImage &snapshot)
+{
+    m_rendering = false;
+    m_pool->viewRendered();
+
+    if (requestId != -1 && m_busy && requestId == m_request.id) {
+        finish(snapshot);
+    }
+}
+
+void OffscreenView::loadingChanged()
+{
+    if (!m_busy || !m_view) {
+        return;
+    }
+
+    if (m_view->loading()) {
+        // Redirected or reloaded, wait for the new load.
+        m_settleTimer.stop();
+    } else {
+        m_settleTimer.start(m_pool->settleTime());
+    }
+}
+
+void OffscreenView::sceneChanged()
+{
+    if (m_busy) {
+        m_pool->requestRender(this);
+    }
+}
+
+void OffscreenView::capture()
+{
+    m_captureRequested = true;
+    m_pool->requestRender(this);
+}
+
+void OffscreenView::timedOut()
+{
+    qCDebug(lcWebviewLog) << "Offscreen rendering of" << m_request.url << "timed out";
+    finish(QImage());
+}
+
+void OffscreenView::viewDestroyed()
+{
+    // Live views are destroyed on engine shutdown.
+    if (m_busy) {
+        finish(QImage());
+    }
+    m_idleTimer.start(0);
+}
+
+void OffscreenView::finish(const QImage &snapshot)
+{
+    const OffscreenViewPool::Request request = m_request;
+    cancel();
+    m_pool->viewFinished(this, request, snapshot);
+}
+
+OffscreenViewPool::OffscreenViewPool(QObject *parent)
+    : QObject(parent)
+    , m_maximumConcurrency(1)
+    , m_settleTime(DEFAULT_SETTLE_TIME)
+    , m_timeout(DEFAULT_TIMEOUT)
+    , m_nextId(1)
+    , m_rendering(false)
+{
+    if (QScreen *screen = QGuiApplication::primaryScreen()) {
+        m_viewportSize = screen->size();
+    }
+
+    m_renderTimer.setSingleShot(true);
+    m_renderTimer.setInterval(FOREGROUND_FRAME_TIMEOUT);
+    connect(&m_renderTimer, &QTimer::timeout, this, &OffscreenViewPool::renderNext);
+}
+
+OffscreenViewPool::~OffscreenViewPool()
+{
+    qDeleteAll(m_views);
+    m_renderThread.quit();
+    m_renderThread.wait();
+}
+
+QObject *OffscreenViewPool::create(QQmlEngine *engine, QJSEngine *scriptEngine)
+{
+    Q_UNUSED(engine)
+    Q_UNUSED(scriptEngine)
+    return new OffscreenViewPool;
+}
+
+int OffscreenViewPool::maximumConcurrency() const
+{
+    return m_maximumConcurrency;
+}
+
+void OffscreenViewPool::setMaximumConcurrency(int concurrency)
+{
+    concurrency = qMax(1, concurrency);
+    if (m_maximumConcurrency != concurrency) {
+        m_maximumConcurrency = concurrency;
+        emit maximumConcurrencyChanged();
+        schedule();
+    }
+}
+
+QSize OffscreenViewPool::viewportSize() const
+{
+    return m_viewportSize;
+}
+
+void OffscreenViewPool::setViewportSize(const QSize &size)
+{
+    if (m_viewportSize != size && !size.isEmpty()) {
+        m_viewportSize = size;
+        emit viewportSizeChanged();
+    }
+}
+
+int OffscreenViewPool::settleTime() const
+{
+    return m_settleTime;
+}
+
+void OffscreenViewPool::setSettleTime(int time)
+{
+    time = qMax(0, time);
+    if (m_settleTime != time) {
+        m_settleTime = time;
+        emit settleTimeChanged();
+    }
+}
+
+int OffscreenViewPool::timeout() const
+{
+    return m_timeout;
+}
+
+void OffscreenViewPool::setTimeout(int timeout)
+{
+    timeout = qMax(0, timeout);
+    if (m_timeout != timeout) {
+        m_timeout = timeout;
+        emit timeoutChanged();
+    }
+}
+
+int OffscreenViewPool::pending() const
+{
+    return m_queue.count();
+}
+
+int OffscreenViewPool::running() const
+{
+    int count = 0;
+    for (const OffscreenView *view : m_views) {
+        if (view->busy()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+int OffscreenViewPool::render(const QUrl &url, const QSize &size)
+{
+    if (!url.isValid() || size.isEmpty() || m_viewportSize.isEmpty()) {
+        return -1;
+    }
+
+    Request request;
+    request.id = m_nextId;
+    request.url = url;
+    request.size = size;
+    m_nextId = m_nextId < INT_MAX ? m_nextId + 1 : 1;
+
+    m_queue.enqueue(request);
+    emit pendingChanged();
+    // Started from the event loop, so that failed() is never emitted before
+    // the caller has the id.
+    QMetaObject::invokeMethod(this, "schedule", Qt::QueuedConnection);
+    return request.id;
+}
+
+void OffscreenViewPool::cancel(int id)
+{
+    for (int i = 0; i < m_queue.count(); ++i) {
+        if (m_queue.at(i).id == id) {
+            m_queue.removeAt(i);
+            emit pendingChanged();
+            return;
+        }
+    }
+
+    for (OffscreenView *view : m_views) {
+        if (view->requestId() == id) {
+            view->cancel();
+            emit runningChanged();
+            schedule();
+            return;
+        }
+    }
+}
+
+// Starts queued requests in idle views, creating views up to the limit.
+// If no view can be created while none is running, e.g. without OpenGL,
+// the queued requests fail.
+void OffscreenViewPool::schedule()
+{
+    bool started = false;
+    while (!m_queue.isEmpty()) {
+        OffscreenView *idleView = nullptr;
+        for (OffscreenView *view : m_views) {
+            if (!view->busy() && view->isValid()) {
+                idleView = view;
+                break;
+            }
+        }
+
+        if (!idleView) {
+            if (running() >= m_maximumConcurrency) {
+                break;
+            }
+            idleView = new OffscreenView(this);
+            if (!idleView->isValid()) {
+                delete idleView;
+                // Running views take the next requests when they finish.
+                if (running() == 0) {
+                    failPending();
+                }
+                break;
+            }
+            m_views.append(idleView);
+        }
+
+        const Request request = m_queue.dequeue();
+        idleView->start(request, m_viewportSize, m_timeout);
+        started = true;
+    }
+
+    if (started) {
+        emit pendingChanged();
+        emit runningChanged();
+    }
+}
+
+void OffscreenViewPool::failPending()
+{
+    const QQueue<Request> queue = m_queue;
+    m_queue.clear();
+    emit pendingChanged();
+
+    qCWarning(lcWebviewLog) << "Cannot create an offscreen view, failing" << queue.count() << "requests";
+    for (const Request &request : queue) {
+        emit failed(request.id, request.url);
+    }
+}
+
+void OffscreenViewPool::requestRender(OffscreenView *view)
+{
+    if (!m_renderQueue.contains(view)) {
+        m_renderQueue.append(view);
+    }
+    scheduleRender();
+}
+
+// Waits for the offscreen frame in progress to finish, and then for the
+// next frame of the visible windows to be presented, or for them to be
+// idle.
+void OffscreenViewPool::scheduleRender()
+{
+    if (m_rendering || m_renderTimer.isActive() || m_renderQueue.isEmpty()) {
+        return;
+    }
+
+    QQuickWindow *window = foregroundWindow();
+    if (window != m_foregroundWindow) {
+        if (m_foregroundWindow) {
+            disconnect(m_foregroundWindow.data(), &QQuickWindow::frameSwapped,
+                       this, &OffscreenViewPool::foregroundFrameSwapped);
+        }
+        m_foregroundWindow = window;
+        if (window) {
+            // Emitted on the render thread.
+            connect(window, &QQuickWindow::frameSwapped,
+                    this, &OffscreenViewPool::foregroundFrameSwapped, Qt::QueuedConnection);
+        }
+    }
+
+    m_renderTimer.start();
+}
+
+void OffscreenViewPool::foregroundFrameSwapped()
+{
+    if (m_renderTimer.isActive()) {
+        m_renderTimer.stop();
+        renderNext();
+    }
+}
+
+// The render thread is shared, a frame is only started once the previous
+// one has been rendered and read back.
+void OffscreenViewPool::renderNext()
+{
+    if (m_rendering) {
+        return;
+    }
+
+    while (!m_renderQueue.isEmpty()) {
+        QPointer<OffscreenView> view = m_renderQueue.takeFirst();
+        if (view && view->render()) {
+            m_rendering = true;
+            break;
+        }
+    }
+
+    scheduleRender();
+}
+
+void OffscreenViewPool::viewRendered()
+{
+    m_rendering = false;
+    scheduleRender();
+}
+
+void OffscreenViewPool::viewFinished(OffscreenView *view, const Request &request, const QImage &snapshot)
+{
+    m_renderQueue.removeAll(view);
+
+    if (snapshot.isNull()) {
+        emit failed(request.id, request.url);
+    } else {
+        const quint32 key = SNAPSHOT_KEY_FLAG | quint32(request.id);
+        SnapshotCache::instance()->insert(key, snapshot);
+        emit finished(request.id, request.url,
+                      QStringLiteral("image://webviewsnapshot/%1/%2").arg(key).arg(request.id));
+    }
+
+    emit runningChanged();
+    schedule();
+}
+
+void OffscreenViewPool::viewIdle(OffscreenView *view)
+{
+    if (!view->busy()) {
+        m_views.removeOne(view);
+        m_renderQueue.removeAll(view);
+        view->deleteLater();
+    }
+}
+
+// Shared by the offscreen views, started with the first one.
+QThread *OffscreenViewPool::renderThread()
+{
+    if (!m_renderThread.isRunning()) {
+        m_renderThread.setObjectName(QStringLiteral("OffscreenViewRenderer"));
+        m_renderThread.start();
+    }
+    return &m_renderThread;
+}
+
+QQuickWindow *OffscreenViewPool::foregroundWindow() const
+{
+    const QList<QWindow *> windows = QGuiApplication::topLevelWindows();
+    for (QWindow *window : windows) {
+        QQuickWindow *quickWindow = qobject_cast<QQuickWindow *>(window);
+        if (quickWindow && quickWindow->isVisible() && quickWindow->isExposed()) {
+            return quickWindow;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#include "offscreenviewpool.moc"
@@ -0,0 +1,135 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_WEBVIEW_OFFSCREENVIEWPOOL_H
+#define SAILFISHOS_WEBVIEW_OFFSCREENVIEWPOOL_H
+
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtCore/QSize>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+
+class QJSEngine;
+class QQmlEngine;
+class QQuickWindow;
+
+namespace SailfishOS {
+
+namespace WebView {
+
+class OffscreenView;
+
+// Renders pages that are not displayed, e.g. link previews and thumbnails.
+// Each page is loaded in a RawWebView of an offscreen window, which is
+// rendered through the usual scene graph path with QQuickRenderControl.
+// At most maximumConcurrency pages are loaded at a time, the rest wait in
+// a queue. Offscreen frames are started one per frame of the visible
+// windows, right after it has been presented, and are rendered and read
+// back one at a time on a render thread of the pool, so that the
+// foreground view keeps its frame rate.
+class OffscreenViewPool : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int maximumConcurrency READ maximumConcurrency WRITE setMaximumConcurrency NOTIFY maximumConcurrencyChanged)
+    Q_PROPERTY(QSize viewportSize READ viewportSize WRITE setViewportSize NOTIFY viewportSizeChanged)
+    Q_PROPERTY(int settleTime READ settleTime WRITE setSettleTime NOTIFY settleTimeChanged)
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
+    Q_PROPERTY(int pending READ pending NOTIFY pendingChanged)
+    Q_PROPERTY(int running READ running NOTIFY runningChanged)
+
+public:
+    explicit OffscreenViewPool(QObject *parent = nullptr);
+    ~OffscreenViewPool();
+
+    static QObject *create(QQmlEngine *engine, QJSEngine *scriptEngine);
+
+    int maximumConcurrency() const;
+    void setMaximumConcurrency(int concurrency);
+
+    // Size of the page layout, the screen size by default.
+    QSize viewportSize() const;
+    void setViewportSize(const QSize &size);
+
+    // Milliseconds from the end of the load to the capture.
+    int settleTime() const;
+    void setSettleTime(int time);
+
+    // Milliseconds from the start of the load to giving up.
+    int timeout() const;
+    void setTimeout(int timeout);
+
+    int pending() const;
+    int running() const;
+
+    // Queues a snapshot of url scaled to size, returns the request id.
+    Q_INVOKABLE int render(const QUrl &url, const QSize &size);
+    Q_INVOKABLE void cancel(int id);
+
+    struct Request
+    {
+        int id;
+        QUrl url;
+        QSize size;
+    };
+
+signals:
+    void maximumConcurrencyChanged();
+    void viewportSizeChanged();
+    void settleTimeChanged();
+    void timeoutChanged();
+    void pendingChanged();
+    void runningChanged();
+
+    // snapshotUrl is an image://webviewsnapshot url of the snapshot.
+    void finished(int id, const QUrl &url, const QString &snapshotUrl);
+    void failed(int id, const QUrl &url);
+
+private slots:
+    void schedule();
+    void foregroundFrameSwapped();
+    void renderNext();
+
+private:
+    friend class OffscreenView;
+
+    void failPending();
+    void scheduleRender();
+    void requestRender(OffscreenView *view);
+    void viewRendered();
+    void viewFinished(OffscreenView *view, const Request &request, const QImage &snapshot);
+    void viewIdle(OffscreenView *view);
+    QThread *renderThread();
+    QQuickWindow *foregroundWindow() const;
+
+    QQueue<Request> m_queue;
+    QList<OffscreenView *> m_views;
+    QList<QPointer<OffscreenView>> m_renderQueue;
+    QPointer<QQuickWindow> m_foregroundWindow;
+    QThread m_renderThread;
+    // Renders when the visible windows are idle and present no frames.
+    QTimer m_renderTimer;
+    QSize m_viewportSize;
+    int m_maximumConcurrency;
+    int m_settleTime;
+    int m_timeout;
+    int m_nextId;
+    // An offscreen frame is being rendered on the render thread
+    bool m_rendering;
+};
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#endif // SAILFISHOS_WEBVIEW_OFFSCREENVIEWPOOL_H
@@ -9,7 +9,12 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "plugin.h"
+#include "clipboardbridge.h"
+#include "offscreenviewpool.h"
 #include "rawwebview.h"
+#include "snapshotcache.h"
+#include "translationregistry.h"
+#include "webviewpool.h"
 #include "webengine.h"
 #include "webenginesettings.h"
 
@@ -24,9 +29,9 @@
 
 #include <QQuickWindow>
 #include <QWindow>
-#include <QClipboard>
 #include <QGuiApplication>
 #include <QDir>
+#include <QUrl>
 #include <QMap>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -270,6 +275,24 @@ WebViewShutdownController *shutdownController(SailfishOS::WebEngine *webEngine)
     return controller;
 }
 
+// Shared by all QML engines of the process.
+ClipboardBridge *clipboardBridge(SailfishOS::WebEngine *webEngine)
+{
+    static QPointer<ClipboardBridge> bridge;
+    if (!bridge) {
+        bridge = new ClipboardBridge(webEngine);
+        QObject::connect(webEngine, &SailfishOS::WebEngine::recvObserve, bridge.data(),
+                         [](const QString &message, const QVariant &data) {
+            if (message == QLatin1String("clipboard:setdata")) {
+                bridge->setData(data);
+            } else if (message == QLatin1String("clipboard:getdata")) {
+                bridge->getData(data);
+            }
+        });
+    }
+    return bridge;
+}
+
 }
 
 const auto MOZILLA_DATA_UA_UPDATE = QStringLiteral("ua-update.json");
@@ -279,6 +302,10 @@ void SailfishOSWebViewPlugin::registerTypes(const char *uri)
 {
     Q_ASSERT(uri == QLatin1String("Sailfish.WebView"));
     qmlRegisterType<SailfishOS::WebView::RawWebView>("Sailfish.WebView", 1, 0, "RawWebView");
+    qmlRegisterSingletonType<SailfishOS::WebView::WebViewPool>("Sailfish.WebView", 1, 0, "WebViewPool",
+                                                               SailfishOS::WebView::WebViewPool::create);
+    qmlRegisterSingletonType<SailfishOS::WebView::OffscreenViewPool>("Sailfish.WebView", 1, 0, "OffscreenViewPool",
+                                                                     SailfishOS::WebView::OffscreenViewPool::create);
     // RawWebView inherits QuickMozView which has some pointer typed properties which need some extra
     // registration. a bit hazy where these should be really registered but here it works,
     // on QuickMozView ctor it doesn't
@@ -290,10 +317,9 @@ void SailfishOSWebViewPlugin::initializeEngine(QQmlEngine *engine, const char *u
 {
     Q_ASSERT(uri == QLatin1String("Sailfish.WebView"));
 
-    AppTranslator *engineeringEnglish = new AppTranslator(engine);
-    AppTranslator *translator = new AppTranslator(engine);
-    engineeringEnglish->load("sailfish_components_webview_qt5_eng_en", "/usr/share/translations");
-    translator->load(QLocale(), "sailfish_components_webview_qt5", "-", "/usr/share/translations");
+    TranslationRegistry::instance()->addCatalog(
+                engine, QStringLiteral("sailfish_components_webview_qt5"),
+                QStringList() << QStringLiteral("sailfish_components_webview-"));
 
     QString path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
     initUserAgentOverrides(path);
@@ -305,28 +331,30 @@ void SailfishOSWebViewPlugin::initializeEngine(QQmlEngine *engine, const char *u
     SailfishOS::WebEngineSettings *engineSettings = SailfishOS::WebEngineSettings::instance();
 
     // For some yet unknown reason QmlMozView crashes when
-    // flicking quickly if progressive-paint is enabled.
-    engineSettings->setPreference("layers.progressive-paint", QVariant::fromValue<bool>(false));
+    // flicking quickly if progressive-paint is enabled. Developers can
+    // enable it with SAILFISH_WEBVIEW_PROGRESSIVE_PAINT=1 to reproduce the
+    // crash with the flickstress benchmark.
+    const bool progressivePaint = qEnvironmentVariableIntValue("SAILFISH_WEBVIEW_PROGRESSIVE_PAINT") > 0;
+    engineSettings->setPreference("layers.progressive-paint", QVariant::fromValue<bool>(progressivePaint));
     // Disable low-precision-buffer so that background underdraw works
-    // correctly.
-    engineSettings->setPreference("layers.low-precision-buffer", QVariant::fromValue<bool>(false));
+    // correctly. It only helps together with progressive-paint.
+    engineSettings->setPreference("layers.low-precision-buffer", QVariant::fromValue<bool>(progressivePaint));
 
     shutdownController(webEngine)->watchEngine(engine);
 
-    connect(webEngine, &SailfishOS::WebEngine::recvObserve, [](const QString &message, const QVariant &data) {
-        const QVariantMap dataMap = data.toMap();
-        if (message == QLatin1String("clipboard:setdata")) {
-            QClipboard *clipboard = QGuiApplication::clipboard();
+    engine->addImageProvider(QStringLiteral("webviewsnapshot"), new SnapshotImageProvider);
 
-            // check if we copied password
-            if (!dataMap.value(QStringLiteral("private")).toBool()) {
-                clipboard->setText(dataMap.value(QStringLiteral("data")).toString());
-            }
-        }
-    });
+    // Loaded by every view into its own frames before its first page load.
+    const QDir importDir(baseUrl().toLocalFile());
+    RawWebView::setFrameScripts(QStringList()
+            << QUrl::fromLocalFile(importDir.filePath(QStringLiteral("TextZoom.js"))).toString()
+            << QUrl::fromLocalFile(importDir.filePath(QStringLiteral("ViewReset.js"))).toString());
+
+    clipboardBridge(webEngine);
 
     // subscribe to gecko messages
     webEngine->addObserver(QStringLiteral("clipboard:setdata"));
+    webEngine->addObserver(QStringLiteral("clipboard:getdata"));
 }
 
 void SailfishOSWebViewPlugin::initUserAgentOverrides(const QString &path)
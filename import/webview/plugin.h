@@ -11,7 +11,6 @@
 #ifndef SAILFISHOS_WEBVIEW_PLUGIN_H
 #define SAILFISHOS_WEBVIEW_PLUGIN_H
 
-#include <QtCore/QTranslator>
 #include <QtCore/QLocale>
 
 #include <QtQml/QQmlExtensionPlugin>
@@ -36,24 +35,6 @@ private:
     void initUserAgentOverrides(const QString &path);
 };
 
-// using custom translator so it gets properly removed from qApp when engine is deleted
-class AppTranslator: public QTranslator
-{
-    Q_OBJECT
-
-public:
-    AppTranslator(QObject *parent)
-        : QTranslator(parent)
-    {
-        qApp->installTranslator(this);
-    }
-
-    virtual ~AppTranslator()
-    {
-        qApp->removeTranslator(this);
-    }
-};
-
 } // namespace WebView
 
 } // namespace SailfishOS
@@ -10,23 +10,42 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "rawwebview.h"
+#include "framestatistics.h"
+#include "messagestatisticsmodel.h"
+#include "snapshotcache.h"
 
 #include "webengine.h"
 #include "webenginesettings.h"
+#include "logging.h"
 
 #include <qmozviewcreator.h>
 
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QtGlobal>
 #include <QtGui/QGuiApplication>
 #include <QtGui/QScreen>
 #include <QtGui/QStyleHints>
 #include <QtGui/QMouseEvent>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFramebufferObject>
+#include <QtGui/QOpenGLFunctions>
 #include <QtQuick/QQuickWindow>
 #include <private/qquickwindow_p.h>
 
 #include <algorithm>
 
 #define CONTENT_ORIENTATION_CHANGED QLatin1String("embed:contentOrientationChanged")
+#define TEXT_ZOOM QLatin1String("embedui:textZoom")
+#define VIEW_INITIAL_STATE QLatin1String("embedui:viewInitialState")
+#define RESET_VIEW QLatin1String("embedui:resetView")
+#define MESSAGE_STATISTICS_INTERVAL 5000
+// Bounds of the wait for the content to be rendered in a new orientation,
+// within them the wait adapts to the measured rotation latency.
+#define MINIMUM_ROTATION_FAILSAFE 200
+#define MAXIMUM_ROTATION_FAILSAFE 1000
+
+Q_GLOBAL_STATIC(QStringList, frameScriptUrls)
 
 namespace SailfishOS {
 
@@ -93,24 +112,150 @@ std::shared_ptr<ViewCreator> ViewCreator::existingInstance()
     return viewCreatorInstance().lock();
 }
 
+// A snapshot request is shared by the view and the render thread of its
+// window, the render thread may still be capturing when the view is gone.
+struct SnapshotRequest
+{
+    SnapshotRequest()
+        : view(nullptr)
+        , scale(1.0)
+        , viewId(0)
+        , requested(false)
+    {
+    }
+
+    QMutex mutex;
+    // Cleared when the view is destroyed
+    RawWebView *view;
+    QRect rect;
+    qreal scale;
+    quint32 viewId;
+    bool requested;
+};
+
+// Frame statistics are recorded on the render thread of the window, which
+// may still be recording a frame when the view is gone.
+struct FrameRecorder
+{
+    FrameRecorder()
+        : contentPending(true)
+        , active(false)
+    {
+        clock.start();
+    }
+
+    void addFrame()
+    {
+        QMutexLocker locker(&mutex);
+        if (!active) {
+            return;
+        }
+        const qint64 timestamp = clock.nsecsElapsed();
+        statistics.addFrame(timestamp, contentPending);
+        recentStatistics.addFrame(timestamp, contentPending);
+    }
+
+    QMutex mutex;
+    FrameStatistics statistics;
+    FrameStatistics recentStatistics;
+    QElapsedTimer clock;
+    bool contentPending;
+    bool active;
+};
+
 
 RawWebView::RawWebView(QQuickItem *parent)
     : QuickMozView(parent)
     , m_viewCreator(ViewCreator::instance())
+    , m_messageStatisticsModel(nullptr)
+    , m_frameRecorder(std::make_shared<FrameRecorder>())
+    , m_frameInstrumentation(false)
+    , m_firstPainted(false)
+    , m_averageRotationLatency(0.0)
+    , m_rotationLatency(-1)
+    , m_snapshotRequest(std::make_shared<SnapshotRequest>())
+    , m_snapshotSerial(0)
     , m_vkbMargin(0.0)
     , m_footerMargin(0.0)
+    , m_textZoom(1.0)
     , m_acceptTouchEvents(true)
+    , m_flickableEmbedded(false)
+    , m_viewInitialized(false)
+    , m_pooled(false)
+    , m_handedOut(false)
+    , m_resetPending(false)
 {
     m_viewCreator->views.push_back(this);
+    m_snapshotRequest->view = this;
 
-    addMessageListener(CONTENT_ORIENTATION_CHANGED);
+    m_messageDispatcher.addHandler(CONTENT_ORIENTATION_CHANGED, [this](const QString &, const QVariant &data) {
+        return onContentOrientationChanged(data);
+    });
+    // Only messages that have no native handler are delivered to QML.
+    m_messageDispatcher.setFallback([this](const QString &message, const QVariant &data) {
+        emit asyncMessage(message, data);
+        return false;
+    });
+    addMessageListeners(QStringList() << CONTENT_ORIENTATION_CHANGED);
 
     connect(this, &QuickMozView::recvAsyncMessage, this, &RawWebView::onAsyncMessage);
+    connect(this, &QuickMozView::viewInitialized, this, &RawWebView::onViewInitialized);
+
+    // Instrumentation can be enabled in production builds with
+    // QT_LOGGING_RULES="org.sailfishos.webview.debug=true".
+    m_messageStatisticsTimer.setInterval(MESSAGE_STATISTICS_INTERVAL);
+    connect(&m_messageStatisticsTimer, &QTimer::timeout, this, &RawWebView::updateMessageStatistics);
+    setMessageInstrumentation(lcWebviewLog().isDebugEnabled());
+
+    m_rotationFailsafe.setSingleShot(true);
+    connect(&m_rotationFailsafe, &QTimer::timeout, this, [this]() {
+        finishRotation(true);
+    });
+    connect(this, &QuickMozView::orientationChanged, this, &RawWebView::startRotation);
+
+    // Frame instrumentation follows the message instrumentation default.
+    m_frameStatisticsTimer.setInterval(MESSAGE_STATISTICS_INTERVAL);
+    connect(&m_frameStatisticsTimer, &QTimer::timeout, this, &RawWebView::updateFrameStatistics);
+    connect(this, &QQuickItem::windowChanged, this, &RawWebView::updateFrameWindow);
+    connect(this, &QQuickItem::windowChanged, this, &RawWebView::cancelSnapshot);
+    connect(this, &QQuickItem::visibleChanged, this, &RawWebView::updateFrameWindow);
+    connect(this, &QuickMozView::firstPaint, this, [this]() {
+        m_firstPainted = true;
+        updateFrameRecorder();
+    });
+    connect(this, &RawWebView::rotatingChanged, this, &RawWebView::updateFrameRecorder);
+    connect(this, &QuickMozView::movingChanged, this, &RawWebView::updateFrameRecorder);
+    connect(this, &QuickMozView::pinchingChanged, this, &RawWebView::updateFrameRecorder);
+
+    connect(this, &QuickMozView::loadingChanged, this, &RawWebView::updateResetPending);
+    connect(this, &QuickMozView::urlChanged, this, &RawWebView::updateResetPending);
+
+    // Async scroll throttling follows the shown views.
+    connect(this, &QuickMozView::activeChanged, this, &RawWebView::updateAsyncScrollThrottling);
+    connect(this, &QQuickItem::visibleChanged, this, &RawWebView::updateAsyncScrollThrottling);
+    setFrameInstrumentation(lcWebviewLog().isDebugEnabled());
 }
 
 RawWebView::~RawWebView()
 {
+    disconnect(m_snapshotConnection);
+    {
+        // A capture in progress on the render thread keeps the request alive,
+        // it no longer reports back once the view has been detached.
+        QMutexLocker locker(&m_snapshotRequest->mutex);
+        m_snapshotRequest->view = nullptr;
+        m_snapshotRequest->requested = false;
+    }
+    // Nothing is inserted for the view after it has been detached.
+    SnapshotCache::instance()->remove(uniqueId());
+
+    // A frame being recorded on the render thread keeps the recorder alive.
+    disconnect(m_frameConnection);
+
     m_viewCreator->views.erase(std::find(m_viewCreator->views.begin(), m_viewCreator->views.end(), this));
+    if (m_flickableEmbedded) {
+        updateAsyncScrollThrottling();
+    }
 }
 
 bool RawWebView::hasLiveViews()
@@ -233,6 +378,42 @@ void RawWebView::setAcceptTouchEvents(bool accept)
     }
 }
 
+bool RawWebView::flickableEmbedded() const
+{
+    return m_flickableEmbedded;
+}
+
+void RawWebView::setFlickableEmbedded(bool embedded)
+{
+    if (m_flickableEmbedded != embedded) {
+        m_flickableEmbedded = embedded;
+        updateAsyncScrollThrottling();
+        emit flickableEmbeddedChanged();
+    }
+}
+
+// The async scroll preferences are global, frequent scroll events are
+// requested only while a view embedded in a flickable is shown and the
+// application has not set its own values.
+void RawWebView::updateAsyncScrollThrottling()
+{
+    std::shared_ptr<ViewCreator> creator = ViewCreator::existingInstance();
+    SailfishOS::WebEngine *webEngine = SailfishOS::WebEngine::instance();
+    if (!creator || !webEngine->isInitialized()) {
+        return;
+    }
+
+    bool flickable = false;
+    for (RawWebView *view : creator->views) {
+        if (view->m_flickableEmbedded && view->active() && view->isVisible()) {
+            flickable = true;
+            break;
+        }
+    }
+
+    SailfishOS::WebEngineSettings::instance()->setFlickableAsyncScrolling(flickable);
+}
+
 void RawWebView::touchEvent(QTouchEvent *event)
 {
     if (m_acceptTouchEvents || event->type() != QEvent::TouchBegin) {
@@ -320,30 +501,614 @@ void RawWebView::touchEvent(QTouchEvent *event)
     }
 }
 
-void RawWebView::onAsyncMessage(const QString &message, const QVariant &data)
+// Topics already registered through this method are skipped.
+void RawWebView::addMessageListeners(const QStringList &topics)
+{
+    for (const QString &topic : topics) {
+        if (topic.isEmpty()) {
+            continue;
+        }
+        m_messageListeners.insert(topic);
+        if (!m_registeredMessageListeners.contains(topic)) {
+            m_registeredMessageListeners.insert(topic);
+            addMessageListener(topic);
+        }
+    }
+}
+
+// Routes messages of the given topics to the handler object instead of
+// the asyncMessage signal. See MessageDispatcher::addHandler().
+void RawWebView::addMessageHandler(const QStringList &topics, QObject *handler)
+{
+    if (!handler) {
+        return;
+    }
+
+    for (const QString &topic : topics) {
+        m_messageDispatcher.addHandler(topic, handler);
+    }
+    if (!m_messageHandlers.contains(handler)) {
+        m_messageHandlers.append(handler);
+        connect(handler, &QObject::destroyed, this, &RawWebView::onMessageHandlerDestroyed);
+    }
+}
+
+void RawWebView::removeMessageHandler(QObject *handler)
+{
+    if (!handler) {
+        return;
+    }
+
+    m_messageDispatcher.removeHandler(handler);
+    if (m_messageHandlers.removeAll(handler) > 0) {
+        disconnect(handler, &QObject::destroyed, this, &RawWebView::onMessageHandlerDestroyed);
+    }
+}
+
+void RawWebView::onMessageHandlerDestroyed(QObject *handler)
+{
+    m_messageDispatcher.removeHandler(handler);
+    m_messageHandlers.removeAll(QPointer<QObject>());
+}
+
+// Per topic message counts and time in milliseconds spent handling them.
+QVariantMap RawWebView::messageStatistics() const
 {
-    if (message == CONTENT_ORIENTATION_CHANGED) {
-        const QString orientationName = data.toMap().value("orientation").toString();
-        Qt::ScreenOrientation mappedOrientation;
-        if (orientationName == QStringLiteral("portrait-primary")) {
-            mappedOrientation = Qt::PortraitOrientation;
-        } else if (orientationName == QStringLiteral("landscape-primary")) {
-            mappedOrientation = Qt::LandscapeOrientation;
-        } else if (orientationName == QStringLiteral("landscape-secondary")) {
-            mappedOrientation = Qt::InvertedLandscapeOrientation;
-        } else if (orientationName == QStringLiteral("portrait-secondary")) {
-            mappedOrientation = Qt::InvertedPortraitOrientation;
+    QVariantMap statistics;
+    const QHash<QString, MessageDispatcher::TopicStatistics> topics = m_messageDispatcher.statistics();
+    for (auto it = topics.constBegin(); it != topics.constEnd(); ++it) {
+        QVariantMap topic;
+        topic.insert(QStringLiteral("count"), it.value().count);
+        topic.insert(QStringLiteral("time"), it.value().handlerTime / 1000000.0);
+        statistics.insert(it.key(), topic);
+    }
+    return statistics;
+}
+
+bool RawWebView::messageInstrumentation() const
+{
+    return m_messageDispatcher.instrumentationEnabled();
+}
+
+void RawWebView::setMessageInstrumentation(bool enabled)
+{
+    if (m_messageDispatcher.instrumentationEnabled() != enabled) {
+        m_messageDispatcher.setInstrumentationEnabled(enabled);
+        if (enabled) {
+            m_messageDispatcher.resetStatistics();
+            m_messageStatisticsTimer.start();
         } else {
-            qWarning() << "Ignoring unknown WebView content orientation:" << orientationName;
-            return;
+            m_messageStatisticsTimer.stop();
+            updateMessageStatistics();
+        }
+        emit messageInstrumentationChanged();
+    }
+}
+
+QObject *RawWebView::messageStatisticsModel()
+{
+    if (!m_messageStatisticsModel) {
+        m_messageStatisticsModel = new MessageStatisticsModel(this);
+        m_messageStatisticsModel->setStatistics(m_messageDispatcher.statistics());
+    }
+    return m_messageStatisticsModel;
+}
+
+qreal RawWebView::textZoom() const
+{
+    return m_textZoom;
+}
+
+void RawWebView::setTextZoom(qreal zoom)
+{
+    if (zoom <= 0.0) {
+        zoom = 1.0;
+    }
+
+    if (m_textZoom != zoom) {
+        m_textZoom = zoom;
+        applyTextZoom();
+        emit textZoomChanged();
+    }
+}
+
+// True from an orientation change until the content has been rendered in
+// the new orientation, or the wait for it timed out.
+bool RawWebView::rotating() const
+{
+    return m_rotationTimer.isValid();
+}
+
+// Milliseconds the last rotation took, -1 if it timed out or none is done.
+int RawWebView::rotationLatency() const
+{
+    return m_rotationLatency;
+}
+
+void RawWebView::startRotation()
+{
+    if (!isVisible() || !m_viewInitialized) {
+        return;
+    }
+
+    const bool wasRotating = rotating();
+    m_rotationTimer.start();
+
+    const int failsafe = m_averageRotationLatency > 0.0
+            ? qBound(MINIMUM_ROTATION_FAILSAFE, qRound(2 * m_averageRotationLatency), MAXIMUM_ROTATION_FAILSAFE)
+            : MAXIMUM_ROTATION_FAILSAFE;
+    m_rotationFailsafe.start(failsafe);
+
+    if (!wasRotating) {
+        emit rotatingChanged();
+    }
+}
+
+void RawWebView::finishRotation(bool timedOut)
+{
+    if (!rotating()) {
+        return;
+    }
+
+    const qint64 latency = m_rotationTimer.elapsed();
+    m_rotationTimer.invalidate();
+    m_rotationFailsafe.stop();
+
+    if (timedOut) {
+        m_rotationLatency = -1;
+        qCDebug(lcWebviewLog) << "Rotation of view" << uniqueId() << "timed out after" << latency << "ms";
+    } else {
+        m_rotationLatency = latency;
+        m_averageRotationLatency = m_averageRotationLatency > 0.0
+                ? 0.75 * m_averageRotationLatency + 0.25 * latency
+                : latency;
+        qCDebug(lcWebviewLog) << "Rotation of view" << uniqueId() << "took" << latency << "ms";
+    }
+
+    emit rotatingChanged();
+}
+
+// Called on the render thread after the scene has been rendered, the
+// frame is still in the back buffer. The view area is downscaled on the
+// GPU when possible, so that only the snapshot itself is read back.
+static void grabSnapshot(const std::shared_ptr<SnapshotRequest> &request, QQuickWindow *window)
+{
+    QMutexLocker locker(&request->mutex);
+    if (!request->requested || !request->view) {
+        return;
+    }
+    request->requested = false;
+
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context) {
+        return;
+    }
+
+    // The framebuffer may have been resized since the request, e.g. by a
+    // rotation while flicking, never read outside of it.
+    GLint viewport[4];
+    context->functions()->glGetIntegerv(GL_VIEWPORT, viewport);
+    const QRect sourceRect = request->rect.intersected(QRect(viewport[0], viewport[1], viewport[2], viewport[3]));
+    if (sourceRect.isEmpty()) {
+        return;
+    }
+    const QSize targetSize = (QSizeF(sourceRect.size()) * request->scale).toSize().expandedTo(QSize(1, 1));
+
+    QImage snapshot;
+    if (QOpenGLFramebufferObject::hasOpenGLFramebufferBlit()) {
+        QOpenGLFramebufferObject target(targetSize);
+        QOpenGLFramebufferObject::blitFramebuffer(&target, QRect(QPoint(), targetSize),
+                                                  window->renderTarget(), sourceRect,
+                                                  GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        snapshot = target.toImage();
+        // Leave the scene graph's framebuffer bound.
+        if (window->renderTarget()) {
+            window->renderTarget()->bind();
+        } else {
+            QOpenGLFramebufferObject::bindDefault();
+        }
+    } else {
+        QImage frame(sourceRect.size(), QImage::Format_RGBA8888_Premultiplied);
+        context->functions()->glReadPixels(sourceRect.x(), sourceRect.y(), sourceRect.width(), sourceRect.height(),
+                                           GL_RGBA, GL_UNSIGNED_BYTE, frame.bits());
+        // Smooth scaling of the full frame would stall the render thread.
+        snapshot = frame.mirrored().scaled(targetSize, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+    }
+
+    SnapshotCache::instance()->insert(request->viewId, snapshot);
+    // Posted events of a view are discarded when it is destroyed.
+    QMetaObject::invokeMethod(request->view, "snapshotCaptured", Qt::QueuedConnection);
+}
+
+// image:// url of the last snapshot of the view, empty if there is none.
+QString RawWebView::snapshotUrl() const
+{
+    return m_snapshotUrl;
+}
+
+// Captures the next frame of the view scaled by the given factor. The
+// frame is read back on the render thread, snapshotUrl changes once the
+// snapshot is in the cache. Returns false if the view is not shown.
+bool RawWebView::captureSnapshot(qreal scale)
+{
+    QQuickWindow *window = this->window();
+    if (!window || !isVisible() || width() <= 0 || height() <= 0) {
+        return false;
+    }
+
+    const qreal devicePixelRatio = window->effectiveDevicePixelRatio();
+    const QSize framebufferSize = window->renderTarget()
+            ? window->renderTarget()->size()
+            : window->size() * devicePixelRatio;
+    const QRectF sceneRect = mapRectToScene(boundingRect());
+    const QRect rect = QRectF(sceneRect.topLeft() * devicePixelRatio,
+                              sceneRect.size() * devicePixelRatio).toAlignedRect()
+            .intersected(QRect(QPoint(), framebufferSize));
+    if (rect.isEmpty()) {
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_snapshotRequest->mutex);
+        // OpenGL framebuffer coordinates grow upwards.
+        m_snapshotRequest->rect = QRect(rect.x(), framebufferSize.height() - rect.y() - rect.height(),
+                                        rect.width(), rect.height());
+        m_snapshotRequest->scale = qBound<qreal>(0.05, scale, 1.0);
+        m_snapshotRequest->viewId = uniqueId();
+        m_snapshotRequest->requested = true;
+    }
+
+    if (m_snapshotWindow != window) {
+        disconnect(m_snapshotConnection);
+        m_snapshotWindow = window;
+        // The slot object, and with it the request, stays alive while the
+        // render thread is in it, even if the view disconnects meanwhile.
+        const std::shared_ptr<SnapshotRequest> request = m_snapshotRequest;
+        m_snapshotConnection = connect(window, &QQuickWindow::afterRendering, window, [request, window]() {
+            grabSnapshot(request, window);
+        }, Qt::DirectConnection);
+    }
+    window->update();
+    return true;
+}
+
+void RawWebView::clearSnapshot()
+{
+    SnapshotCache::instance()->remove(uniqueId());
+    if (!m_snapshotUrl.isEmpty()) {
+        m_snapshotUrl.clear();
+        emit snapshotUrlChanged();
+    }
+}
+
+void RawWebView::snapshotCaptured()
+{
+    disconnect(m_snapshotConnection);
+    m_snapshotWindow.clear();
+
+    m_snapshotUrl = QStringLiteral("image://webviewsnapshot/%1/%2").arg(uniqueId()).arg(++m_snapshotSerial);
+    emit snapshotUrlChanged();
+}
+
+// A request pending on the render thread of the previous window is dropped
+// when the view moves to another window.
+void RawWebView::cancelSnapshot()
+{
+    if (!m_snapshotWindow || m_snapshotWindow == window()) {
+        return;
+    }
+
+    disconnect(m_snapshotConnection);
+    m_snapshotWindow.clear();
+
+    // Wait for a capture in progress on the render thread.
+    QMutexLocker locker(&m_snapshotRequest->mutex);
+    m_snapshotRequest->requested = false;
+}
+
+bool RawWebView::pooled() const
+{
+    return m_pooled;
+}
+
+bool RawWebView::enterPool()
+{
+    // Frame scripts do the reset, they are loaded on initialization.
+    if (m_pooled || !m_viewInitialized) {
+        return false;
+    }
+
+    // Handlers of the view itself, e.g. those of WebView, stay.
+    const QList<QPointer<QObject>> handlers = m_messageHandlers;
+    for (const QPointer<QObject> &handler : handlers) {
+        QObject *ancestor = handler;
+        while (ancestor && ancestor != this) {
+            ancestor = ancestor->parent();
+        }
+        if (handler && !ancestor) {
+            removeMessageHandler(handler);
+        }
+    }
+    m_messageHandlers.removeAll(QPointer<QObject>());
+
+    // Topics of earlier users are still sent by the engine, but no longer
+    // delivered, see onAsyncMessage().
+    m_messageListeners = m_componentMessageListeners;
+
+    clearSnapshot();
+    setVirtualKeyboardMargin(0.0);
+    m_messageDispatcher.resetStatistics();
+    finishRotation(true);
+
+    // Purges the session history and loads about:blank, see ViewReset.js.
+    sendAsyncMessage(RESET_VIEW, QVariantMap());
+
+    m_pooled = true;
+    m_resetPending = true;
+    m_resetFromUrl = url();
+    emit pooledChanged();
+    updateResetPending();
+    return true;
+}
+
+void RawWebView::leavePool()
+{
+    // Topics registered until the view is first handed out are those of
+    // the view and its component, later ones are of its users.
+    if (!m_handedOut) {
+        m_handedOut = true;
+        m_componentMessageListeners = m_messageListeners;
+    }
+
+    if (m_pooled) {
+        m_pooled = false;
+        emit pooledChanged();
+    }
+}
+
+bool RawWebView::resetPending() const
+{
+    return m_resetPending;
+}
+
+// The reset is done once about:blank has been loaded. Until then the url
+// is that of the previous user, so any other url is of the next user.
+void RawWebView::updateResetPending()
+{
+    if (!m_resetPending) {
+        return;
+    }
+
+    const bool blank = url() == QUrl(QStringLiteral("about:blank"));
+    if ((blank && !loading()) || (!blank && !m_pooled && url() != m_resetFromUrl)) {
+        m_resetPending = false;
+        emit resetFinished();
+    }
+}
+
+bool RawWebView::frameInstrumentation() const
+{
+    return m_frameInstrumentation;
+}
+
+void RawWebView::setFrameInstrumentation(bool enabled)
+{
+    if (m_frameInstrumentation != enabled) {
+        m_frameInstrumentation = enabled;
+        if (enabled) {
+            resetFrameStatistics();
+            m_frameStatisticsTimer.start();
+        } else {
+            m_frameStatisticsTimer.stop();
+            updateFrameStatistics();
+        }
+        updateFrameWindow();
+        emit frameInstrumentationChanged();
+    }
+}
+
+QVariantMap RawWebView::frameStatistics() const
+{
+    return m_frameStatisticsMap;
+}
+
+void RawWebView::resetFrameStatistics()
+{
+    {
+        QMutexLocker locker(&m_frameRecorder->mutex);
+        m_frameRecorder->statistics.reset();
+        m_frameRecorder->recentStatistics.reset();
+        m_frameStatisticsMap = m_frameRecorder->statistics.toVariantMap();
+    }
+    emit frameStatisticsChanged();
+}
+
+// Frames are counted while the view is shown and instrumented.
+void RawWebView::updateFrameWindow()
+{
+    QQuickWindow *window = m_frameInstrumentation && isVisible() ? this->window() : nullptr;
+    if (window == m_frameWindow) {
+        return;
+    }
+
+    disconnect(m_frameConnection);
+
+    m_frameWindow = window;
+    if (window) {
+        std::shared_ptr<FrameRecorder> recorder = m_frameRecorder;
+        if (QScreen *screen = window->screen()) {
+            QMutexLocker locker(&recorder->mutex);
+            recorder->statistics.setRefreshRate(screen->refreshRate());
+            recorder->recentStatistics.setRefreshRate(screen->refreshRate());
+        }
+        // Emitted on the render thread once the frame has been presented.
+        m_frameConnection = connect(window, &QQuickWindow::frameSwapped, window, [recorder]() {
+            recorder->addFrame();
+        }, Qt::DirectConnection);
+    }
+}
+
+// The window renders on demand and for any of its items, so its frames
+// are only attributed to the view while the view moves: while it is
+// dragged, flicked, pinched or rotated. The pauses of on demand rendering
+// in between, e.g. for a blinking caret, are not frame intervals. The view
+// shows no up to date content before its first paint and while it waits
+// for the content to be rendered in a new orientation.
+void RawWebView::updateFrameRecorder()
+{
+    const bool active = moving() || pinching() || rotating();
+
+    QMutexLocker locker(&m_frameRecorder->mutex);
+    if (m_frameRecorder->active && !active) {
+        m_frameRecorder->statistics.interrupt();
+        m_frameRecorder->recentStatistics.interrupt();
+    }
+    m_frameRecorder->active = active;
+    m_frameRecorder->contentPending = !m_firstPainted || rotating();
+}
+
+void RawWebView::updateFrameStatistics()
+{
+    FrameStatistics recent;
+    {
+        QMutexLocker locker(&m_frameRecorder->mutex);
+        m_frameStatisticsMap = m_frameRecorder->statistics.toVariantMap();
+        recent = m_frameRecorder->recentStatistics;
+        m_frameRecorder->recentStatistics.reset();
+    }
+    emit frameStatisticsChanged();
+
+    if (lcWebviewLog().isDebugEnabled() && recent.frames() > 0) {
+        qCDebug(lcWebviewLog).nospace()
+                << "Frame statistics for view " << uniqueId()
+                << " frames: " << recent.frames()
+                << " dropped: " << recent.droppedFrames()
+                << " interval: " << recent.averageInterval() / 1000000.0 << " ms"
+                << " (max " << recent.maximumInterval() / 1000000.0 << " ms)"
+                << " checkerboard: " << recent.checkerboardTime() / 1000000.0 << " ms"
+                << " jank: " << recent.histogram(0) << "/" << recent.histogram(1)
+                << "/" << recent.histogram(2) << "/" << recent.histogram(3)
+                << "/" << recent.histogram(4);
+    }
+}
+
+void RawWebView::updateMessageStatistics()
+{
+    const QHash<QString, MessageDispatcher::TopicStatistics> statistics = m_messageDispatcher.statistics();
+
+    if (m_messageStatisticsModel) {
+        m_messageStatisticsModel->setStatistics(statistics);
+    }
+
+    if (lcWebviewLog().isDebugEnabled() && !statistics.isEmpty()) {
+        QList<QString> topics = statistics.keys();
+        std::sort(topics.begin(), topics.end(), [&statistics](const QString &a, const QString &b) {
+            return statistics.value(a).count > statistics.value(b).count;
+        });
+
+        qCDebug(lcWebviewLog) << "Message statistics for view" << uniqueId();
+        for (const QString &topic : topics) {
+            const MessageDispatcher::TopicStatistics &topicStatistics = statistics[topic];
+            qCDebug(lcWebviewLog).nospace()
+                    << "  " << topic
+                    << " count: " << topicStatistics.count
+                    << " payload: " << topicStatistics.payloadSize << " bytes"
+                    << " handler: " << topicStatistics.handlerTime / 1000000.0 << " ms"
+                    << " (max " << topicStatistics.maxHandlerTime / 1000000.0 << " ms)"
+                    << " qml: " << topicStatistics.qmlHandlerTime / 1000000.0 << " ms";
         }
-        emit contentOrientationChanged(mappedOrientation);
-        // Force a fresh scene-graph update so the reoriented WebRender frame
-        // is presented without waiting for additional user interaction.
-        update();
     }
 }
 
+// State the frame scripts of the view apply before the first layout,
+// delivered to the content process as a single embedui:viewInitialState
+// message. The color scheme and safe-area insets are applied natively when
+// the view is initialized, viewport and orientation by QuickMozView.
+QVariantMap RawWebView::initialState() const
+{
+    QVariantMap state;
+    state.insert(QStringLiteral("textZoom"), m_textZoom);
+    return state;
+}
+
+void RawWebView::onViewInitialized()
+{
+    m_viewInitialized = true;
+
+    // Everything below reaches the content process before the first load,
+    // so the first layout is the final one.
+    SailfishOS::WebEngineSettings::instance()->notifyViewInitialized();
+    if (!m_safeAreaInsets.isNull()) {
+        setSafeAreaInsets(m_safeAreaInsets);
+    }
+    if (m_flickableEmbedded) {
+        updateAsyncScrollThrottling();
+    }
+
+    // The scripts are loaded by the message manager of this view only,
+    // they see the initial state as their first message.
+    for (const QString &url : *frameScriptUrls()) {
+        loadFrameScript(url);
+    }
+
+    sendAsyncMessage(VIEW_INITIAL_STATE, initialState());
+}
+
+void RawWebView::setFrameScripts(const QStringList &urls)
+{
+    *frameScriptUrls() = urls;
+}
+
+// The zoom is kept by the browsing context over navigations, so it is only
+// sent when it changes. TextZoom.js skips a zoom its browsing context
+// already has.
+void RawWebView::applyTextZoom()
+{
+    if (!m_viewInitialized) {
+        return;
+    }
+
+    QVariantMap data;
+    data.insert(QStringLiteral("zoom"), m_textZoom);
+    sendAsyncMessage(TEXT_ZOOM, data);
+}
+
+void RawWebView::onAsyncMessage(const QString &message, const QVariant &data)
+{
+    // Registered by an earlier user of the pooled view.
+    if (m_registeredMessageListeners.contains(message) && !m_messageListeners.contains(message)) {
+        return;
+    }
+
+    m_messageDispatcher.dispatch(message, data);
+}
+
+bool RawWebView::onContentOrientationChanged(const QVariant &data)
+{
+    const QString orientationName = data.toMap().value("orientation").toString();
+    Qt::ScreenOrientation mappedOrientation;
+    if (orientationName == QStringLiteral("portrait-primary")) {
+        mappedOrientation = Qt::PortraitOrientation;
+    } else if (orientationName == QStringLiteral("landscape-primary")) {
+        mappedOrientation = Qt::LandscapeOrientation;
+    } else if (orientationName == QStringLiteral("landscape-secondary")) {
+        mappedOrientation = Qt::InvertedLandscapeOrientation;
+    } else if (orientationName == QStringLiteral("portrait-secondary")) {
+        mappedOrientation = Qt::InvertedPortraitOrientation;
+    } else {
+        qWarning() << "Ignoring unknown WebView content orientation:" << orientationName;
+        return true;
+    }
+    emit contentOrientationChanged(mappedOrientation);
+    if (mappedOrientation == orientation()) {
+        finishRotation(false);
+    }
+    // Force a fresh scene-graph update so the reoriented WebRender frame
+    // is presented without waiting for additional user interaction.
+    update();
+    return true;
+}
+
 } // namespace WebView
 
 } // namespace SailfishOS
@@ -12,18 +12,28 @@
 #ifndef SAILFISHOS_WEBVIEW_H
 #define SAILFISHOS_WEBVIEW_H
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QMargins>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
 #include <QtQuick/QQuickItem>
 
 //mozembedlite-qt5
 #include <quickmozview.h>
 #include <memory>
 
+#include "messagedispatcher.h"
+
 namespace SailfishOS {
 
 namespace WebView {
 
 class ViewCreator;
+class MessageStatisticsModel;
+struct SnapshotRequest;
+struct FrameRecorder;
 
 class RawWebView : public QuickMozView
 {
@@ -35,6 +45,16 @@ class RawWebView : public QuickMozView
     Q_PROPERTY(int safeAreaBottom READ safeAreaBottom WRITE setSafeAreaBottom NOTIFY safeAreaChanged)
     Q_PROPERTY(int safeAreaLeft READ safeAreaLeft WRITE setSafeAreaLeft NOTIFY safeAreaChanged)
     Q_PROPERTY(bool _acceptTouchEvents READ acceptTouchEvents WRITE setAcceptTouchEvents NOTIFY acceptTouchEventsChanged)
+    Q_PROPERTY(bool _flickableEmbedded READ flickableEmbedded WRITE setFlickableEmbedded NOTIFY flickableEmbeddedChanged)
+    Q_PROPERTY(bool messageInstrumentation READ messageInstrumentation WRITE setMessageInstrumentation NOTIFY messageInstrumentationChanged)
+    Q_PROPERTY(QObject *messageStatisticsModel READ messageStatisticsModel CONSTANT)
+    Q_PROPERTY(qreal textZoom READ textZoom WRITE setTextZoom NOTIFY textZoomChanged)
+    Q_PROPERTY(bool rotating READ rotating NOTIFY rotatingChanged)
+    Q_PROPERTY(int rotationLatency READ rotationLatency NOTIFY rotatingChanged)
+    Q_PROPERTY(QString snapshotUrl READ snapshotUrl NOTIFY snapshotUrlChanged)
+    Q_PROPERTY(bool pooled READ pooled NOTIFY pooledChanged)
+    Q_PROPERTY(bool frameInstrumentation READ frameInstrumentation WRITE setFrameInstrumentation NOTIFY frameInstrumentationChanged)
+    Q_PROPERTY(QVariantMap frameStatistics READ frameStatistics NOTIFY frameStatisticsChanged)
 
 public:
     RawWebView(QQuickItem *parent = 0);
@@ -64,6 +84,58 @@ public:
     bool acceptTouchEvents() const;
     void setAcceptTouchEvents(bool accept);
 
+    // True when the view is scrolled together with a QQuickFlickable, e.g.
+    // in WebViewFlickable, which needs frequent async scroll events.
+    bool flickableEmbedded() const;
+    void setFlickableEmbedded(bool embedded);
+
+    // Registers each topic once per view.
+    Q_INVOKABLE void addMessageListeners(const QStringList &topics);
+
+    Q_INVOKABLE void addMessageHandler(const QStringList &topics, QObject *handler);
+    Q_INVOKABLE void removeMessageHandler(QObject *handler);
+    Q_INVOKABLE QVariantMap messageStatistics() const;
+
+    bool messageInstrumentation() const;
+    void setMessageInstrumentation(bool enabled);
+
+    QObject *messageStatisticsModel();
+
+    bool frameInstrumentation() const;
+    void setFrameInstrumentation(bool enabled);
+
+    // Frame timing since instrumentation was enabled or reset, updated
+    // every few seconds. See FrameStatistics.
+    QVariantMap frameStatistics() const;
+    Q_INVOKABLE void resetFrameStatistics();
+
+    qreal textZoom() const;
+    void setTextZoom(qreal zoom);
+
+    Q_INVOKABLE QVariantMap initialState() const;
+
+    // Frame scripts loaded by every view into its own frames when the view
+    // is initialized, before the first page load.
+    static void setFrameScripts(const QStringList &urls);
+
+    bool rotating() const;
+    int rotationLatency() const;
+
+    QString snapshotUrl() const;
+    Q_INVOKABLE bool captureSnapshot(qreal scale = 0.5);
+    Q_INVOKABLE void clearSnapshot();
+
+    // True while the view is kept warm in WebViewPool.
+    bool pooled() const;
+    // Resets the view to about:blank without history and drops the state
+    // of its previous user. Returns false if the view can't be reused.
+    bool enterPool();
+    // Hands the view to a user, also called for views created by the pool.
+    void leavePool();
+    // True from enterPool() until the view has loaded about:blank or shows
+    // a page of its next user, resetFinished() is emitted then.
+    bool resetPending() const;
+
 protected:
     void touchEvent(QTouchEvent *event);
 
@@ -73,18 +145,82 @@ signals:
     void safeAreaChanged();
     void contentOrientationChanged(Qt::ScreenOrientation orientation);
     void acceptTouchEventsChanged();
+    void flickableEmbeddedChanged();
     void openUrlInNewWindow();
+    void asyncMessage(const QString &message, const QVariant &data);
+    void messageInstrumentationChanged();
+    void textZoomChanged();
+    void rotatingChanged();
+    void snapshotUrlChanged();
+    void pooledChanged();
+    void resetFinished();
+    void frameInstrumentationChanged();
+    void frameStatisticsChanged();
+
+private slots:
+    void snapshotCaptured();
 
 private:
     void applySafeAreaInsets(const QMargins &insets);
     void onAsyncMessage(const QString &message, const QVariant &data);
+    bool onContentOrientationChanged(const QVariant &data);
+    void onMessageHandlerDestroyed(QObject *handler);
+    void updateMessageStatistics();
+    void onViewInitialized();
+    void updateResetPending();
+    void applyTextZoom();
+    void startRotation();
+    void finishRotation(bool timedOut);
+    void cancelSnapshot();
+    void updateFrameWindow();
+    void updateFrameRecorder();
+    void updateFrameStatistics();
+    static void updateAsyncScrollThrottling();
 
     std::shared_ptr<ViewCreator> m_viewCreator;
+    MessageDispatcher m_messageDispatcher;
+    // Topics delivered to the current user of the view
+    QSet<QString> m_messageListeners;
+    // Topics registered with the engine, which can't be undone
+    QSet<QString> m_registeredMessageListeners;
+    // Topics registered before the view was first handed out by WebViewPool
+    QSet<QString> m_componentMessageListeners;
+    QList<QPointer<QObject>> m_messageHandlers;
+    MessageStatisticsModel *m_messageStatisticsModel;
+    QTimer m_messageStatisticsTimer;
+    QTimer m_rotationFailsafe;
+    // Shared with the render thread, which records the frames
+    std::shared_ptr<FrameRecorder> m_frameRecorder;
+    QTimer m_frameStatisticsTimer;
+    QPointer<QQuickWindow> m_frameWindow;
+    QMetaObject::Connection m_frameConnection;
+    QVariantMap m_frameStatisticsMap;
+    bool m_frameInstrumentation;
+    bool m_firstPainted;
+    QElapsedTimer m_rotationTimer;
+    // Milliseconds, moving average of the completed rotations
+    qreal m_averageRotationLatency;
+    int m_rotationLatency;
+    // Shared with the render thread, which takes the requested snapshot
+    std::shared_ptr<SnapshotRequest> m_snapshotRequest;
+    // Window whose render thread takes the requested snapshot
+    QPointer<QQuickWindow> m_snapshotWindow;
+    QMetaObject::Connection m_snapshotConnection;
+    quint32 m_snapshotSerial;
+    QString m_snapshotUrl;
     qreal m_vkbMargin;
     qreal m_footerMargin;
+    qreal m_textZoom;
     QMargins m_safeAreaInsets;
     QPointF m_startPos;
     bool m_acceptTouchEvents;
+    bool m_flickableEmbedded;
+    bool m_viewInitialized;
+    bool m_pooled;
+    bool m_handedOut;
+    bool m_resetPending;
+    // Page of the previous user when the view entered the pool
+    QUrl m_resetFromUrl;
 };
 
 } // namespace WebView
@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "snapshotcache.h"
+
+#include <QtCore/QMutexLocker>
+
+// Room for a handful of half scale snapshots
+#define DEFAULT_MAXIMUM_SIZE (16 * 1024 * 1024)
+
+namespace SailfishOS {
+
+namespace WebView {
+
+Q_GLOBAL_STATIC(SnapshotCache, snapshotCacheInstance)
+
+SnapshotCache *SnapshotCache::instance()
+{
+    return snapshotCacheInstance();
+}
+
+SnapshotCache::SnapshotCache()
+    : m_snapshots(DEFAULT_MAXIMUM_SIZE)
+{
+}
+
+void SnapshotCache::insert(quint32 viewId, const QImage &snapshot)
+{
+    QMutexLocker locker(&m_mutex);
+    m_snapshots.insert(viewId, new QImage(snapshot), snapshot.byteCount());
+}
+
+void SnapshotCache::remove(quint32 viewId)
+{
+    QMutexLocker locker(&m_mutex);
+    m_snapshots.remove(viewId);
+}
+
+QImage SnapshotCache::snapshot(quint32 viewId) const
+{
+    QMutexLocker locker(&m_mutex);
+    const QImage *snapshot = m_snapshots.object(viewId);
+    return snapshot ? *snapshot : QImage();
+}
+
+int SnapshotCache::maximumSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_snapshots.maxCost();
+}
+
+void SnapshotCache::setMaximumSize(int size)
+{
+    QMutexLocker locker(&m_mutex);
+    m_snapshots.setMaxCost(size);
+}
+
+SnapshotImageProvider::SnapshotImageProvider()
+    : QQuickImageProvider(QQuickImageProvider::Image)
+{
+}
+
+QImage SnapshotImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    QImage snapshot = SnapshotCache::instance()->snapshot(id.section(QLatin1Char('/'), 0, 0).toUInt());
+    if (!snapshot.isNull() && requestedSize.width() > 0 && requestedSize.height() > 0
+            && requestedSize != snapshot.size()) {
+        snapshot = snapshot.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    if (size) {
+        *size = snapshot.size();
+    }
+    return snapshot;
+}
+
+} // namespace WebView
+
+} // namespace SailfishOS
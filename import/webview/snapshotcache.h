@@ -0,0 +1,60 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_WEBVIEW_SNAPSHOTCACHE_H
+#define SAILFISHOS_WEBVIEW_SNAPSHOTCACHE_H
+
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtGui/QImage>
+#include <QtQuick/QQuickImageProvider>
+
+namespace SailfishOS {
+
+namespace WebView {
+
+// Process wide cache of view snapshots by view id. Snapshots are inserted
+// from the render thread and read by the image provider, which may run in
+// a thread of its own.
+class SnapshotCache
+{
+public:
+    static SnapshotCache *instance();
+
+    SnapshotCache();
+
+    void insert(quint32 viewId, const QImage &snapshot);
+    void remove(quint32 viewId);
+    QImage snapshot(quint32 viewId) const;
+
+    // Bytes, the least recently captured snapshots are dropped first.
+    int maximumSize() const;
+    void setMaximumSize(int size);
+
+private:
+    mutable QMutex m_mutex;
+    QCache<quint32, QImage> m_snapshots;
+};
+
+// Serves image://webviewsnapshot/<view id>/<serial>, the serial is only
+// there to make each capture a new url.
+class SnapshotImageProvider : public QQuickImageProvider
+{
+public:
+    SnapshotImageProvider();
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+};
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#endif // SAILFISHOS_WEBVIEW_SNAPSHOTCACHE_H
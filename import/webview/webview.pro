@@ -17,10 +17,24 @@ QMAKE_CXXFLAGS += -fPIC
 INCLUDEPATH += . src ../../lib
 LIBS += -L../../lib -lsailfishwebengine
 
-HEADERS += plugin.h \
-            rawwebview.h
-SOURCES += plugin.cpp \
-            rawwebview.cpp
+HEADERS += clipboardbridge.h \
+            framestatistics.h \
+            messagedispatcher.h \
+            messagestatisticsmodel.h \
+            offscreenviewpool.h \
+            plugin.h \
+            rawwebview.h \
+            snapshotcache.h \
+            webviewpool.h
+SOURCES += clipboardbridge.cpp \
+            framestatistics.cpp \
+            messagedispatcher.cpp \
+            messagestatisticsmodel.cpp \
+            offscreenviewpool.cpp \
+            plugin.cpp \
+            rawwebview.cpp \
+            snapshotcache.cpp \
+            webviewpool.cpp
 OTHER_FILES += qmldir plugins.qmltypes *.qml *.js
 
 include(translations.pri)
@@ -31,6 +45,10 @@ target.path = $$TARGETPATH
 
 INSTALLS += target import translations_install engineering_english_install
 
+# The .js files are frame scripts loaded by Gecko, not by the QML engine.
+QMLCACHE_FILES = $$files(*.qml)
+include(../qmlcache.pri)
+
 # The module is verbose on stdout, hence the use of dedicated FD for output.
 #
 # HACK: pass -nocomposites to work around the issue with types leaked
@@ -0,0 +1,313 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "webviewpool.h"
+#include "rawwebview.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMetaObject>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlContext>
+#include <QtQml/QQmlEngine>
+#include <QtQuick/QQuickItem>
+
+#include "logging.h"
+
+#include <memory>
+
+// Gecko views are heavy, by default a single one is kept.
+#define DEFAULT_MAXIMUM_SIZE 1
+
+namespace SailfishOS {
+
+namespace WebView {
+
+WebViewPool::WebViewPool(QQmlEngine *engine, QObject *parent)
+    : QObject(parent)
+    , m_engine(engine)
+    , m_maximumSize(DEFAULT_MAXIMUM_SIZE)
+    , m_hits(0)
+    , m_misses(0)
+    , m_creations(0)
+    , m_reuses(0)
+    , m_creationTime(0)
+    , m_reuseTime(0)
+    , m_statisticsSerial(0)
+{
+}
+
+WebViewPool::~WebViewPool()
+{
+    trim(0);
+}
+
+QObject *WebViewPool::create(QQmlEngine *engine, QJSEngine *scriptEngine)
+{
+    Q_UNUSED(scriptEngine)
+    return new WebViewPool(engine);
+}
+
+int WebViewPool::maximumSize() const
+{
+    return m_maximumSize;
+}
+
+void WebViewPool::setMaximumSize(int size)
+{
+    size = qMax(0, size);
+    if (m_maximumSize != size) {
+        m_maximumSize = size;
+        trim(m_maximumSize);
+        emit maximumSizeChanged();
+    }
+}
+
+int WebViewPool::count() const
+{
+    return m_idle.count();
+}
+
+int WebViewPool::hits() const
+{
+    return m_hits;
+}
+
+int WebViewPool::misses() const
+{
+    return m_misses;
+}
+
+qreal WebViewPool::creationLatency() const
+{
+    return m_creations > 0 ? m_creationTime / 1000000.0 / m_creations : 0.0;
+}
+
+qreal WebViewPool::reuseLatency() const
+{
+    return m_reuses > 0 ? m_reuseTime / 1000000.0 / m_reuses : 0.0;
+}
+
+QQuickItem *WebViewPool::acquire(QQmlComponent *component, QQuickItem *parent, const QVariantMap &properties)
+{
+    if (!component) {
+        return nullptr;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    purge();
+
+    RawWebView *view = nullptr;
+    for (int i = m_idle.count() - 1; i >= 0; --i) {
+        if (m_idle.at(i).component == component) {
+            view = m_idle.at(i).view;
+            m_idle.remove(i);
+            emit countChanged();
+            break;
+        }
+    }
+
+    if (view) {
+        view->setParent(parent);
+        view->setParentItem(parent);
+        for (auto it = properties.constBegin(); it != properties.constEnd(); ++it) {
+            view->setProperty(it.key().toUtf8().constData(), it.value());
+        }
+        measureLatency(view, timer, true);
+        view->leavePool();
+        view->setVisible(true);
+
+        ++m_hits;
+        emit statisticsChanged();
+        return view;
+    }
+
+    QQmlContext *context = component->creationContext();
+    if (!context && parent) {
+        context = qmlContext(parent);
+    }
+    if (!context && m_engine) {
+        context = m_engine->rootContext();
+    }
+
+    QObject *object = component->beginCreate(context);
+    if (!object) {
+        qCWarning(lcWebviewLog) << "Cannot create pooled view:" << component->errorString();
+        return nullptr;
+    }
+
+    QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
+    object->setParent(parent);
+    if (QQuickItem *item = qobject_cast<QQuickItem *>(object)) {
+        item->setParentItem(parent);
+    }
+    for (auto it = properties.constBegin(); it != properties.constEnd(); ++it) {
+        object->setProperty(it.key().toUtf8().constData(), it.value());
+    }
+    component->completeCreate();
+
+    view = qobject_cast<RawWebView *>(object);
+    if (!view) {
+        qCWarning(lcWebviewLog) << "Pooled component" << component->url() << "is not a WebView";
+        delete object;
+        return nullptr;
+    }
+
+    view->leavePool();
+    m_components.insert(view, component);
+    connect(view, &QObject::destroyed, this, [this, view]() {
+        m_components.remove(view);
+        purge();
+    });
+    connect(component, &QObject::destroyed, this, &WebViewPool::purge, Qt::UniqueConnection);
+
+    qCDebug(lcWebviewLog) << "Created view" << view->uniqueId() << "for the pool in"
+                          << timer.nsecsElapsed() / 1000000.0 << "ms";
+    measureLatency(view, timer, false);
+
+    ++m_misses;
+    emit statisticsChanged();
+    return view;
+}
+
+void WebViewPool::release(QQuickItem *item)
+{
+    if (!item) {
+        return;
+    }
+
+    RawWebView *view = qobject_cast<RawWebView *>(item);
+    if (view && view->pooled()) {
+        return;
+    }
+
+    // The owner of any other item, e.g. a view declared in QML, destroys it.
+    if (!view || !m_components.contains(view)) {
+        qCWarning(lcWebviewLog) << "Ignoring release of" << item << "which was not acquired from the pool";
+        return;
+    }
+
+    purge();
+
+    const QPointer<QQmlComponent> component = m_components.value(view);
+    if (!component || m_idle.count() >= m_maximumSize || !view->enterPool()) {
+        item->setVisible(false);
+        item->deleteLater();
+        return;
+    }
+
+    view->setVisible(false);
+    view->setParentItem(nullptr);
+    view->setParent(this);
+
+    Entry entry;
+    entry.view = view;
+    entry.component = component;
+    m_idle.append(entry);
+    emit countChanged();
+}
+
+void WebViewPool::clear()
+{
+    trim(0);
+}
+
+void WebViewPool::resetStatistics()
+{
+    m_hits = 0;
+    m_misses = 0;
+    m_creations = 0;
+    m_reuses = 0;
+    m_creationTime = 0;
+    m_reuseTime = 0;
+    ++m_statisticsSerial;
+    emit statisticsChanged();
+}
+
+// Adds the latency of an acquisition once its view is ready. A view that
+// is destroyed before drops the measurement with its connection.
+void WebViewPool::measureLatency(RawWebView *view, const QElapsedTimer &timer, bool reused)
+{
+    const uint serial = m_statisticsSerial;
+
+    auto ready = [this, view, reused, timer, serial]() {
+        if (serial != m_statisticsSerial) {
+            return;
+        }
+
+        const qint64 elapsed = timer.nsecsElapsed();
+        if (reused) {
+            ++m_reuses;
+            m_reuseTime += elapsed;
+        } else {
+            ++m_creations;
+            m_creationTime += elapsed;
+        }
+        qCDebug(lcWebviewLog) << (reused ? "Reused pooled view" : "Initialized view") << view->uniqueId()
+                              << "in" << elapsed / 1000000.0 << "ms";
+        emit statisticsChanged();
+    };
+
+    if (reused && !view->resetPending()) {
+        ready();
+        return;
+    }
+
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    auto readyOnce = [ready, connection]() {
+        QObject::disconnect(*connection);
+        ready();
+    };
+    if (reused) {
+        *connection = connect(view, &RawWebView::resetFinished, this, readyOnce);
+    } else {
+        *connection = connect(view, &QuickMozView::viewInitialized, this, readyOnce);
+    }
+}
+
+// Drops views which were destroyed or whose component is gone.
+void WebViewPool::purge()
+{
+    const int previousCount = m_idle.count();
+    for (int i = m_idle.count() - 1; i >= 0; --i) {
+        const Entry &entry = m_idle.at(i);
+        if (!entry.view || !entry.component) {
+            if (entry.view) {
+                entry.view->deleteLater();
+            }
+            m_idle.remove(i);
+        }
+    }
+
+    if (m_idle.count() != previousCount) {
+        emit countChanged();
+    }
+}
+
+// Least recently released views are destroyed first.
+void WebViewPool::trim(int size)
+{
+    const int previousCount = m_idle.count();
+    while (m_idle.count() > size) {
+        if (RawWebView *view = m_idle.first().view) {
+            view->deleteLater();
+        }
+        m_idle.removeFirst();
+    }
+
+    if (m_idle.count() != previousCount) {
+        emit countChanged();
+    }
+}
+
+} // namespace WebView
+
+} // namespace SailfishOS
@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_WEBVIEW_WEBVIEWPOOL_H
+#define SAILFISHOS_WEBVIEW_WEBVIEWPOOL_H
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QVariantMap>
+#include <QtCore/QVector>
+
+class QElapsedTimer;
+class QJSEngine;
+class QQmlComponent;
+class QQmlEngine;
+class QQuickItem;
+
+namespace SailfishOS {
+
+namespace WebView {
+
+class RawWebView;
+
+// Keeps released views warm for the next acquire() of the same component,
+// so that short lived views don't pay for a new Gecko view each time.
+// Latencies are in milliseconds from acquire() until a created view has
+// been initialized by the engine, or until a reused view has finished its
+// reset to about:blank or shows a page of its new user.
+class WebViewPool : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int maximumSize READ maximumSize WRITE setMaximumSize NOTIFY maximumSizeChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int hits READ hits NOTIFY statisticsChanged)
+    Q_PROPERTY(int misses READ misses NOTIFY statisticsChanged)
+    Q_PROPERTY(qreal creationLatency READ creationLatency NOTIFY statisticsChanged)
+    Q_PROPERTY(qreal reuseLatency READ reuseLatency NOTIFY statisticsChanged)
+
+public:
+    explicit WebViewPool(QQmlEngine *engine, QObject *parent = nullptr);
+    ~WebViewPool();
+
+    static QObject *create(QQmlEngine *engine, QJSEngine *scriptEngine);
+
+    int maximumSize() const;
+    void setMaximumSize(int size);
+
+    int count() const;
+
+    int hits() const;
+    int misses() const;
+    qreal creationLatency() const;
+    qreal reuseLatency() const;
+
+    // Returns a pooled view created from component, or a new one. The
+    // properties are set before the view is shown.
+    Q_INVOKABLE QQuickItem *acquire(QQmlComponent *component, QQuickItem *parent,
+                                    const QVariantMap &properties = QVariantMap());
+    // Pools the view if there is room, destroys it otherwise. Views that
+    // acquire() did not create are always destroyed.
+    Q_INVOKABLE void release(QQuickItem *view);
+    Q_INVOKABLE void clear();
+    Q_INVOKABLE void resetStatistics();
+
+signals:
+    void maximumSizeChanged();
+    void countChanged();
+    void statisticsChanged();
+
+private slots:
+    void purge();
+
+private:
+    struct Entry
+    {
+        QPointer<RawWebView> view;
+        QPointer<QQmlComponent> component;
+    };
+
+    void trim(int size);
+    void measureLatency(RawWebView *view, const QElapsedTimer &timer, bool reused);
+
+    QPointer<QQmlEngine> m_engine;
+    QVector<Entry> m_idle;
+    QHash<RawWebView *, QPointer<QQmlComponent>> m_components;
+    int m_maximumSize;
+    int m_hits;
+    int m_misses;
+    // Acquisitions whose view got ready, the latencies are averaged over them
+    int m_creations;
+    int m_reuses;
+    qint64 m_creationTime;
+    qint64 m_reuseTime;
+    // Increased when the statistics are reset, pending measurements of an
+    // earlier period are dropped.
+    uint m_statisticsSerial;
+};
+
+} // namespace WebView
+
+} // namespace SailfishOS
+
+#endif // SAILFISHOS_WEBVIEW_WEBVIEWPOOL_H
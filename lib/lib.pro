@@ -11,11 +11,13 @@ PKGCONFIG += qt5embedwidget sailfishsilica
 
 SOURCES += downloadhelper.cpp \
            logging.cpp \
+           translationregistry.cpp \
            webengine.cpp \
            webenginesettings.cpp
 
 HEADERS += downloadhelper.h \
            logging.h \
+           translationregistry.h \
            webengine.h \
            webenginesettings.h \
            webenginesettings_p.h
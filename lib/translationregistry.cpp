@@ -0,0 +1,193 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "translationregistry.h"
+#include "logging.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QLocale>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QPointer>
+
+namespace SailfishOS {
+
+TranslationRegistry *TranslationRegistry::instance()
+{
+    // Parented to the application, removed from it on destruction.
+    static QPointer<TranslationRegistry> registry;
+    if (!registry) {
+        registry = new TranslationRegistry;
+    }
+    return registry;
+}
+
+TranslationRegistry::TranslationRegistry()
+    : QTranslator(QCoreApplication::instance())
+    , m_installed(false)
+{
+}
+
+void TranslationRegistry::addCatalog(QObject *owner,
+                                     const QString &catalog,
+                                     const QStringList &idPrefixes,
+                                     const QString &directory)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        bool found = false;
+        for (Catalog &existing : m_catalogs) {
+            if (existing.name == catalog) {
+                ++existing.references;
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            Catalog added;
+            added.name = catalog;
+            for (const QString &prefix : idPrefixes) {
+                added.idPrefixes.append(prefix.toUtf8());
+            }
+            added.directory = directory;
+            added.references = 1;
+            added.loaded = false;
+            added.engineeringEnglish = nullptr;
+            added.translator = nullptr;
+            m_catalogs.append(added);
+        }
+    }
+
+    connect(owner, &QObject::destroyed, this, [this, catalog]() {
+        release(catalog);
+    });
+
+    if (!m_installed) {
+        m_installed = true;
+        QCoreApplication::installTranslator(this);
+    }
+}
+
+void TranslationRegistry::addCatalogIds(const QString &catalog, const QStringList &ids)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (Catalog &existing : m_catalogs) {
+        if (existing.name == catalog) {
+            for (const QString &id : ids) {
+                existing.ids.insert(id.toUtf8());
+            }
+            break;
+        }
+    }
+}
+
+QStringList TranslationRegistry::loadedCatalogs() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QStringList loaded;
+    for (const Catalog &catalog : m_catalogs) {
+        if (catalog.loaded) {
+            loaded.append(catalog.name);
+        }
+    }
+    return loaded;
+}
+
+QString TranslationRegistry::translate(const char *context,
+                                       const char *sourceText,
+                                       const char *disambiguation,
+                                       int n) const
+{
+    if (!sourceText) {
+        return QString();
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    const QByteArray id = QByteArray::fromRawData(sourceText, qstrlen(sourceText));
+    for (Catalog &catalog : m_catalogs) {
+        bool matches = catalog.ids.contains(id);
+        for (int i = 0; !matches && i < catalog.idPrefixes.count(); ++i) {
+            const QByteArray &prefix = catalog.idPrefixes.at(i);
+            matches = qstrncmp(sourceText, prefix.constData(), prefix.size()) == 0;
+        }
+        if (!matches) {
+            continue;
+        }
+
+        if (!catalog.loaded) {
+            load(&catalog);
+        }
+
+        // The locale catalog has precedence over engineering English.
+        QString translation = catalog.translator->translate(context, sourceText, disambiguation, n);
+        if (translation.isNull()) {
+            translation = catalog.engineeringEnglish->translate(context, sourceText, disambiguation, n);
+        }
+        if (!translation.isNull()) {
+            return translation;
+        }
+    }
+
+    return QString();
+}
+
+bool TranslationRegistry::isEmpty() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_catalogs.isEmpty();
+}
+
+void TranslationRegistry::load(Catalog *catalog) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // QTranslator maps the .qm files rather than reads them.
+    catalog->engineeringEnglish = new QTranslator;
+    catalog->translator = new QTranslator;
+    catalog->engineeringEnglish->load(catalog->name + QStringLiteral("_eng_en"), catalog->directory);
+    catalog->translator->load(QLocale(), catalog->name, QStringLiteral("-"), catalog->directory);
+    catalog->loaded = true;
+
+    qCDebug(lcWebviewLog) << "Loaded translation catalog" << catalog->name
+                          << "in" << timer.nsecsElapsed() / 1000 << "us";
+}
+
+void TranslationRegistry::release(const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (int i = 0; i < m_catalogs.count(); ++i) {
+        Catalog &catalog = m_catalogs[i];
+        if (catalog.name != name) {
+            continue;
+        }
+
+        if (--catalog.references == 0) {
+            delete catalog.engineeringEnglish;
+            delete catalog.translator;
+            m_catalogs.removeAt(i);
+        }
+        break;
+    }
+
+    if (m_catalogs.isEmpty() && m_installed) {
+        m_installed = false;
+        locker.unlock();
+        QCoreApplication::removeTranslator(this);
+    }
+}
+
+}
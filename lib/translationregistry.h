@@ -0,0 +1,79 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SAILFISHOS_TRANSLATIONREGISTRY_H
+#define SAILFISHOS_TRANSLATIONREGISTRY_H
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+#include <QtCore/QTranslator>
+
+namespace SailfishOS {
+
+// A single translator for the catalogs of the WebView QML modules. A
+// module's engineering English and locale catalogs are loaded the first
+// time an id with one of the module's prefixes is translated, most
+// applications never show the strings of every module.
+class TranslationRegistry : public QTranslator
+{
+    Q_OBJECT
+
+public:
+    static TranslationRegistry *instance();
+
+    // Adds the catalog for as long as owner exists, e.g. the QML engine
+    // of the module. Catalogs are named as <catalog>_eng_en.qm and
+    // <catalog>-<locale>.qm in directory.
+    void addCatalog(QObject *owner,
+                    const QString &catalog,
+                    const QStringList &idPrefixes,
+                    const QString &directory = QStringLiteral("/usr/share/translations"));
+
+    // Adds whole ids to a catalog added before. Ids that a module shares
+    // with another catalog, e.g. with the browser, are registered this way
+    // so that the strings of the other catalog don't load this one.
+    void addCatalogIds(const QString &catalog, const QStringList &ids);
+
+    QStringList loadedCatalogs() const;
+
+    QString translate(const char *context,
+                      const char *sourceText,
+                      const char *disambiguation = nullptr,
+                      int n = -1) const override;
+    bool isEmpty() const override;
+
+private:
+    struct Catalog
+    {
+        QString name;
+        QList<QByteArray> idPrefixes;
+        QSet<QByteArray> ids;
+        QString directory;
+        int references;
+        bool loaded;
+        QTranslator *engineeringEnglish;
+        QTranslator *translator;
+    };
+
+    TranslationRegistry();
+
+    void load(Catalog *catalog) const;
+    void release(const QString &name);
+
+    mutable QMutex m_mutex;
+    mutable QList<Catalog> m_catalogs;
+    bool m_installed;
+};
+
+}
+
+#endif // SAILFISHOS_TRANSLATIONREGISTRY_H
@@ -77,6 +77,12 @@ SailfishOS::WebEngineSettingsPrivate *SailfishOS::WebEngineSettingsPrivate::inst
 
 SailfishOS::WebEngineSettingsPrivate::WebEngineSettingsPrivate(QObject *parent)
     : QObject(parent)
+    , m_viewCreatedNotified(false)
+    , m_asyncScrollThrottle(SAILFISH_WEBENGINE_DEFAULT_ASYNC_SCROLL_THROTTLE)
+    , m_asyncScrollTimeout(SAILFISH_WEBENGINE_DEFAULT_ASYNC_SCROLL_TIMEOUT)
+    , m_asyncScrollThrottleSet(false)
+    , m_asyncScrollTimeoutSet(false)
+    , m_flickableAsyncScrolling(false)
 {
 }
 
@@ -147,6 +153,10 @@ void SailfishOS::WebEngineSettings::initialize()
             engineSettings->d, &SailfishOS::WebEngineSettingsPrivate::oneShotNotifyColorSchemeChanged);
     webEngine->addObserver(QStringLiteral("embedliteviewcreated"));
 
+    // Async scroll throttling is adjusted at runtime by the views, start
+    // from the current value rather than one persisted by an earlier session.
+    engineSettings->d->applyAsyncScrolling();
+
     isInitialized = true;
 
     // Guard preferences that should be written only once. If a preference needs to be
@@ -176,12 +186,6 @@ void SailfishOS::WebEngineSettings::initialize()
     engineSettings->setPixelRatio(pixelRatio);
 
     // Standard settings.
-    // TODO: Fix this so that it can be applied during runtime when QQuickItem based WebView is used with QQuickFlickable.
-    // At the moment just disable it to avoid unnecessary events being fired. JB#39581
-#if 0
-    engineSettings->setPreference(QStringLiteral("apz.asyncscroll.throttle"), QVariant::fromValue<int>(15));
-    engineSettings->setPreference(QStringLiteral("apz.asyncscroll.timeout"), QVariant::fromValue<int>(15));
-#endif
     engineSettings->setPreference(QStringLiteral("apz.fling_stopped_threshold"), QLatin1String("0.13"));
 
     // Theme settings.
@@ -235,12 +239,20 @@ void SailfishOS::WebEngineSettings::initialize()
     \brief Notifies gecko about ambience color scheme changes.
 */
 void SailfishOS::WebEngineSettingsPrivate::notifyColorSchemeChanged()
+{
+    SailfishOS::WebEngine::instance()->notifyObservers(QStringLiteral("ambience-theme-changed"), colorScheme());
+}
+
+/*!
+    \internal
+    \brief Returns the ambience color scheme as passed to gecko, "dark" or "light".
+*/
+QString SailfishOS::WebEngineSettingsPrivate::colorScheme() const
 {
     Silica::Theme *silicaTheme = Silica::Theme::instance();
-    QString scheme = silicaTheme->colorScheme() == Silica::Theme::LightOnDark
+    return silicaTheme->colorScheme() == Silica::Theme::LightOnDark
             ? QStringLiteral("dark")
             : QStringLiteral("light");
-    SailfishOS::WebEngine::instance()->notifyObservers(QStringLiteral("ambience-theme-changed"), scheme);
 }
 
 /*!
@@ -250,7 +262,8 @@ void SailfishOS::WebEngineSettingsPrivate::notifyColorSchemeChanged()
 void SailfishOS::WebEngineSettingsPrivate::oneShotNotifyColorSchemeChanged(const QString &message, const QVariant &data)
 {
     Q_UNUSED(data);
-    if (message == QLatin1String("embedliteviewcreated")) {
+    if (message == QLatin1String("embedliteviewcreated") && !m_viewCreatedNotified) {
+        m_viewCreatedNotified = true;
         SailfishOS::WebEngine *webEngine = SailfishOS::WebEngine::instance();
         // Remove the observer and disconnect the signal
         webEngine->removeObserver(QStringLiteral("embedliteviewcreated"));
@@ -262,6 +275,77 @@ void SailfishOS::WebEngineSettingsPrivate::oneShotNotifyColorSchemeChanged(const
     }
 }
 
+/*!
+    \internal
+    \brief Sets whether a view in a flickable is shown.
+
+    While one is shown, async scroll events are requested every frame unless
+    the application has set its own values.
+*/
+void SailfishOS::WebEngineSettingsPrivate::setFlickableAsyncScrolling(bool enabled)
+{
+    if (m_flickableAsyncScrolling != enabled) {
+        m_flickableAsyncScrolling = enabled;
+        applyAsyncScrolling();
+    }
+}
+
+/*!
+    \internal
+    \brief Writes the async scroll preferences in effect.
+*/
+void SailfishOS::WebEngineSettingsPrivate::applyAsyncScrolling()
+{
+    int throttle = m_asyncScrollThrottle;
+    if (!m_asyncScrollThrottleSet && m_flickableAsyncScrolling) {
+        throttle = SAILFISH_WEBENGINE_FLICKABLE_ASYNC_SCROLL_THROTTLE;
+    }
+    int timeout = m_asyncScrollTimeout;
+    if (!m_asyncScrollTimeoutSet && m_flickableAsyncScrolling) {
+        timeout = SAILFISH_WEBENGINE_FLICKABLE_ASYNC_SCROLL_TIMEOUT;
+    }
+
+    SailfishOS::WebEngineSettings *engineSettings = SailfishOS::WebEngineSettings::instance();
+    engineSettings->setPreference(QStringLiteral("apz.asyncscroll.throttle"), QVariant::fromValue<int>(throttle));
+    engineSettings->setPreference(QStringLiteral("apz.asyncscroll.timeout"), QVariant::fromValue<int>(timeout));
+}
+
+/*!
+    \internal
+    \brief Notifies gecko about the ambience color scheme when a view is initialized.
+
+    Views call this before their first load so that the first layout uses
+    the ambience color scheme without waiting for the embedliteviewcreated
+    notification.
+*/
+void SailfishOS::WebEngineSettingsPrivate::notifyInitialColorScheme()
+{
+    // Handled like the embedliteviewcreated notification, whichever comes first.
+    oneShotNotifyColorSchemeChanged(QStringLiteral("embedliteviewcreated"), QVariant());
+}
+
+/*!
+    \internal
+    \brief Notifies gecko about the ambience color scheme when a view is initialized.
+
+    Called by the web views before their first load.
+*/
+void SailfishOS::WebEngineSettings::notifyViewInitialized()
+{
+    d->notifyInitialColorScheme();
+}
+
+/*!
+    \internal
+    \brief Sets whether a web view in a flickable is shown.
+
+    Called by the web views when they are shown or hidden.
+*/
+void SailfishOS::WebEngineSettings::setFlickableAsyncScrolling(bool enabled)
+{
+    d->setFlickableAsyncScrolling(enabled);
+}
+
 /*!
     \brief Returns the instance of the singleton WebEngineSettings class.
 
@@ -298,3 +382,75 @@ SailfishOS::WebEngineSettings::WebEngineSettings(QObject *parent)
 SailfishOS::WebEngineSettings::~WebEngineSettings()
 {
 }
+
+/*!
+    \property SailfishOS::WebEngineSettings::asyncScrollThrottle
+    \brief The minimum interval between scroll events during async scrolling.
+
+    The interval is in milliseconds. Lower values keep the scroll position
+    seen by the page and by the view closer to the rendered one, at the cost
+    of more events being fired while panning.
+
+    This corresponds to the "apz.asyncscroll.throttle" gecko preference.
+
+    The default value is 100. Until the application sets a value, a WebView
+    inside a \c WebViewFlickable lowers the interval in effect while the
+    view is shown, and restores the default afterwards. The property keeps
+    the value of the application.
+
+    \sa asyncScrollTimeout
+*/
+int SailfishOS::WebEngineSettings::asyncScrollThrottle() const
+{
+    return d->m_asyncScrollThrottle;
+}
+
+void SailfishOS::WebEngineSettings::setAsyncScrollThrottle(int throttle)
+{
+    if (d->m_asyncScrollThrottleSet && d->m_asyncScrollThrottle == throttle) {
+        return;
+    }
+
+    const bool changed = d->m_asyncScrollThrottle != throttle;
+    d->m_asyncScrollThrottle = throttle;
+    d->m_asyncScrollThrottleSet = true;
+    d->applyAsyncScrolling();
+    if (changed) {
+        emit asyncScrollThrottleChanged();
+    }
+}
+
+/*!
+    \property SailfishOS::WebEngineSettings::asyncScrollTimeout
+    \brief The delay of the final scroll event after async scrolling stops.
+
+    The delay is in milliseconds.
+
+    This corresponds to the "apz.asyncscroll.timeout" gecko preference.
+
+    The default value is 300. Until the application sets a value, a WebView
+    inside a \c WebViewFlickable lowers the delay in effect while the view
+    is shown, and restores the default afterwards. The property keeps the
+    value of the application.
+
+    \sa asyncScrollThrottle
+*/
+int SailfishOS::WebEngineSettings::asyncScrollTimeout() const
+{
+    return d->m_asyncScrollTimeout;
+}
+
+void SailfishOS::WebEngineSettings::setAsyncScrollTimeout(int timeout)
+{
+    if (d->m_asyncScrollTimeoutSet && d->m_asyncScrollTimeout == timeout) {
+        return;
+    }
+
+    const bool changed = d->m_asyncScrollTimeout != timeout;
+    d->m_asyncScrollTimeout = timeout;
+    d->m_asyncScrollTimeoutSet = true;
+    d->applyAsyncScrolling();
+    if (changed) {
+        emit asyncScrollTimeoutChanged();
+    }
+}
@@ -25,6 +25,8 @@ class WebEngineSettingsPrivate;
 class WebEngineSettings : public QMozEngineSettings
 {
     Q_OBJECT
+    Q_PROPERTY(int asyncScrollThrottle READ asyncScrollThrottle WRITE setAsyncScrollThrottle NOTIFY asyncScrollThrottleChanged)
+    Q_PROPERTY(int asyncScrollTimeout READ asyncScrollTimeout WRITE setAsyncScrollTimeout NOTIFY asyncScrollTimeoutChanged)
 
 public:
     static void initialize();
@@ -33,6 +35,20 @@ public:
     explicit WebEngineSettings(QObject *parent = 0);
     virtual ~WebEngineSettings();
 
+    int asyncScrollThrottle() const;
+    void setAsyncScrollThrottle(int throttle);
+
+    int asyncScrollTimeout() const;
+    void setAsyncScrollTimeout(int timeout);
+
+    // Used by the views of the webview plugin, not part of the public API.
+    void notifyViewInitialized();
+    void setFlickableAsyncScrolling(bool enabled);
+
+signals:
+    void asyncScrollThrottleChanged();
+    void asyncScrollTimeoutChanged();
+
 private:
     WebEngineSettingsPrivate *d;
 };
@@ -11,6 +11,14 @@
 
 #ifndef Q_QDOC
 
+// Gecko defaults of apz.asyncscroll.throttle and apz.asyncscroll.timeout
+#define SAILFISH_WEBENGINE_DEFAULT_ASYNC_SCROLL_THROTTLE 100
+#define SAILFISH_WEBENGINE_DEFAULT_ASYNC_SCROLL_TIMEOUT 300
+// Used while a view in a flickable is shown, which needs async scroll
+// events every frame to keep the flickable in sync.
+#define SAILFISH_WEBENGINE_FLICKABLE_ASYNC_SCROLL_THROTTLE 15
+#define SAILFISH_WEBENGINE_FLICKABLE_ASYNC_SCROLL_TIMEOUT 15
+
 namespace SailfishOS {
 
 class WebEngineSettingsPrivate : public QObject
@@ -23,9 +31,25 @@ public:
     explicit WebEngineSettingsPrivate(QObject *parent = 0);
     ~WebEngineSettingsPrivate();
 
+    QString colorScheme() const;
+
+    void setFlickableAsyncScrolling(bool enabled);
+    void applyAsyncScrolling();
+
 public slots:
     void notifyColorSchemeChanged();
     void oneShotNotifyColorSchemeChanged(const QString &message, const QVariant &data);
+    void notifyInitialColorScheme();
+
+private:
+    bool m_viewCreatedNotified;
+    // Values of the application, or the defaults until it sets them
+    int m_asyncScrollThrottle;
+    int m_asyncScrollTimeout;
+    bool m_asyncScrollThrottleSet;
+    bool m_asyncScrollTimeoutSet;
+    // A view in a flickable is shown
+    bool m_flickableAsyncScrolling;
 
     friend class WebEngineSettings;
 };
@@ -1,4 +1,8 @@
 %global min_qtmozembed_version 1.56.0
+# Ahead-of-time compiled QML, needs qmlcachegen from Qt 5.9 or later.
+# Off by default, so the default build ships no cache files and gets no
+# startup benefit from it.
+%bcond_with qmlcache
 
 Name:    sailfish-components-webview-qt5
 Summary: Allows embedding Sailfish WebView into applications
@@ -59,6 +63,7 @@ Development package for libsailfishwebengine.
 %package tests
 Summary:    Sailfish WebView tests
 BuildRequires:  pkgconfig(Qt5Test)
+BuildRequires:  pkgconfig(Qt5QuickTest)
 Requires:   %{name} = %{version}-%{release}
 Requires:   qt5-qtdeclarative-import-qttest
 Requires:   nemo-test-tools
@@ -87,7 +92,7 @@ BuildRequires:  qt5-tools
 %autosetup -n %{name}-%{version}
 
 %build
-%qmake5 VERSION=%{version}
+%qmake5 VERSION=%{version} %{!?with_qmlcache:CONFIG+=no_qmlcache}
 %make_build
 
 %install
@@ -113,6 +118,10 @@ BuildRequires:  qt5-tools
 %{_libdir}/qt5/qml/Sailfish/WebView/Controls/qmldir
 %{_libdir}/qt5/qml/Sailfish/WebView/Controls/plugins.qmltypes
 %{_libdir}/qt5/qml/Sailfish/WebView/Controls/*.qml
+%if %{with qmlcache}
+%{_libdir}/qt5/qml/Sailfish/WebView/*.qmlc
+%{_libdir}/qt5/qml/Sailfish/WebView/Controls/*.qmlc
+%endif
 
 %files ts-devel
 %{_datadir}/translations/source/sailfish_components_webview_qt5.ts
@@ -127,6 +136,10 @@ BuildRequires:  qt5-tools
 %{_libdir}/qt5/qml/Sailfish/WebView/Popups/plugins.qmltypes
 %{_libdir}/qt5/qml/Sailfish/WebView/Popups/*.qml
 %{_libdir}/qt5/qml/Sailfish/WebView/Popups/*.js
+%if %{with qmlcache}
+%{_libdir}/qt5/qml/Sailfish/WebView/Popups/*.qmlc
+%{_libdir}/qt5/qml/Sailfish/WebView/Popups/*.jsc
+%endif
 
 %files pickers
 %{_datadir}/translations/sailfish_components_webview_pickers_qt5_eng_en.qm
@@ -134,6 +147,11 @@ BuildRequires:  qt5-tools
 %{_libdir}/qt5/qml/Sailfish/WebView/Pickers/qmldir
 %{_libdir}/qt5/qml/Sailfish/WebView/Pickers/plugins.qmltypes
 %{_libdir}/qt5/qml/Sailfish/WebView/Pickers/*.qml
+%{_libdir}/qt5/qml/Sailfish/WebView/Pickers/*.js
+%if %{with qmlcache}
+%{_libdir}/qt5/qml/Sailfish/WebView/Pickers/*.qmlc
+%{_libdir}/qt5/qml/Sailfish/WebView/Pickers/*.jsc
+%endif
 
 %files devel
 %{_libdir}/libsailfishwebengine.so
@@ -1,2 +1,9 @@
 TEMPLATE = subdirs
-SUBDIRS += tst_downloadhelper
+SUBDIRS += tst_downloadhelper \
+           tst_filehandoff \
+           tst_framestatistics \
+           tst_geckotranslations \
+           tst_popuprequestqueue \
+           tst_selectmodel \
+           tst_textselectiongeometry \
+           tst_translationregistry
@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "filehandoff.h"
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using SailfishOS::WebView::Pickers::FileHandoff;
+
+class tst_filehandoff : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void prepareFile();
+    void invalidFiles();
+    void fileDescriptor();
+    void prepare();
+
+private:
+    QString createFile(const QString &name, const QByteArray &content);
+
+    QTemporaryDir m_dir;
+};
+
+QString tst_filehandoff::createFile(const QString &name, const QByteArray &content)
+{
+    QFile file(m_dir.filePath(name));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    file.write(content);
+    return file.fileName();
+}
+
+void tst_filehandoff::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+void tst_filehandoff::prepareFile()
+{
+    const QString path = createFile(QStringLiteral("notes.txt"), QByteArray("hello world"));
+
+    const QVariantMap file = FileHandoff::prepareFile(QUrl::fromLocalFile(path).toString(), false);
+    QCOMPARE(file.value("path").toString(), path);
+    QCOMPARE(file.value("name").toString(), QStringLiteral("notes.txt"));
+    QCOMPARE(file.value("size").toLongLong(), qint64(11));
+    QCOMPARE(file.value("mimeType").toString(), QStringLiteral("text/plain"));
+    QVERIFY(file.value("lastModified").toLongLong() > 0);
+    QVERIFY(!file.contains("fd"));
+
+    // Without a known extension the content decides.
+    const QString png = createFile(QStringLiteral("image"), QByteArray("\x89PNG\r\n\x1a\n", 8));
+    QCOMPARE(FileHandoff::prepareFile(png, false).value("mimeType").toString(), QStringLiteral("image/png"));
+}
+
+void tst_filehandoff::invalidFiles()
+{
+    QVERIFY(FileHandoff::prepareFile(QString(), false).isEmpty());
+    QVERIFY(FileHandoff::prepareFile(m_dir.filePath(QStringLiteral("missing")), false).isEmpty());
+    QVERIFY(FileHandoff::prepareFile(m_dir.path(), false).isEmpty());
+}
+
+void tst_filehandoff::fileDescriptor()
+{
+    const QString path = createFile(QStringLiteral("data.bin"), QByteArray(100, 'x'));
+
+    const QVariantMap file = FileHandoff::prepareFile(path, true);
+    QVERIFY(file.contains("fd"));
+    const int fd = file.value("fd").toInt();
+    QVERIFY(fcntl(fd, F_GETFD) != -1);
+
+    // The descriptor reads the file from the beginning.
+    char buffer[200];
+    QCOMPARE(read(fd, buffer, sizeof(buffer)), ssize_t(100));
+
+    FileHandoff::closeFileDescriptors(QVariantList() << file);
+    QCOMPARE(fcntl(fd, F_GETFD), -1);
+}
+
+void tst_filehandoff::prepare()
+{
+    QStringList files;
+    for (int i = 0; i < 10; ++i) {
+        files.append(createFile(QStringLiteral("photo%1.jpg").arg(i), QByteArray(i + 1, 'x')));
+    }
+    files.insert(5, m_dir.filePath(QStringLiteral("missing.jpg")));
+
+    FileHandoff handoff;
+    QSignalSpy finishedSpy(&handoff, &FileHandoff::finished);
+    handoff.prepare(files);
+    QVERIFY(handoff.busy());
+
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QVERIFY(!handoff.busy());
+
+    const QVariantList prepared = finishedSpy.first().first().toList();
+    QCOMPARE(prepared.count(), 10);
+    QCOMPARE(prepared.at(5).toMap().value("name").toString(), QStringLiteral("photo5.jpg"));
+    QCOMPARE(prepared.at(5).toMap().value("size").toLongLong(), qint64(6));
+    QCOMPARE(prepared.at(5).toMap().value("mimeType").toString(), QStringLiteral("image/jpeg"));
+}
+
+QTEST_MAIN(tst_filehandoff)
+#include "tst_filehandoff.moc"
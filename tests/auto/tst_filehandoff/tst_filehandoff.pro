@@ -0,0 +1,12 @@
+TARGET = tst_filehandoff
+
+include(../test_common.pri)
+
+target.path = /opt/tests/sailfish-components-webview/auto
+INSTALLS += target
+
+INCLUDEPATH += ../../../import/pickers
+
+HEADERS += ../../../import/pickers/filehandoff.h
+SOURCES += tst_filehandoff.cpp \
+           ../../../import/pickers/filehandoff.cpp
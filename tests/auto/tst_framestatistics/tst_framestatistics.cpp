@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "framestatistics.h"
+
+#include <QtTest>
+
+using SailfishOS::WebView::FrameStatistics;
+
+static const qint64 FRAME = 16666667;
+
+class tst_framestatistics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void smoothFrames();
+    void droppedFrames();
+    void histogramBuckets_data();
+    void histogramBuckets();
+    void idleGap();
+    void interrupt();
+    void checkerboardTime();
+    void variantMap();
+};
+
+void tst_framestatistics::smoothFrames()
+{
+    FrameStatistics statistics;
+    for (int i = 0; i < 60; ++i) {
+        // A millisecond of vsync jitter either way.
+        statistics.addFrame(1000000000 + i * FRAME + (i % 2 ? 1000000 : -1000000));
+    }
+
+    QCOMPARE(statistics.frames(), quint64(60));
+    QCOMPARE(statistics.droppedFrames(), quint64(0));
+    QCOMPARE(statistics.histogram(0), quint64(59));
+    QVERIFY(qAbs(statistics.averageInterval() - FRAME) < 100000);
+}
+
+void tst_framestatistics::droppedFrames()
+{
+    FrameStatistics statistics;
+    statistics.addFrame(0);
+    statistics.addFrame(FRAME);
+    // Two refresh intervals without a frame.
+    statistics.addFrame(4 * FRAME);
+    statistics.addFrame(5 * FRAME);
+
+    QCOMPARE(statistics.droppedFrames(), quint64(2));
+    QCOMPARE(statistics.histogram(0), quint64(2));
+    QCOMPARE(statistics.histogram(2), quint64(1));
+    QCOMPARE(statistics.maximumInterval(), 3 * FRAME);
+
+    // At 30 Hz the same interval is a single missed frame.
+    FrameStatistics slow(30.0);
+    slow.addFrame(0);
+    slow.addFrame(4 * FRAME);
+    QCOMPARE(slow.droppedFrames(), quint64(1));
+}
+
+void tst_framestatistics::histogramBuckets_data()
+{
+    QTest::addColumn<int>("missedFrames");
+    QTest::addColumn<int>("bucket");
+
+    QTest::newRow("none") << 0 << 0;
+    QTest::newRow("one") << 1 << 1;
+    QTest::newRow("two") << 2 << 2;
+    QTest::newRow("three") << 3 << 2;
+    QTest::newRow("four") << 4 << 3;
+    QTest::newRow("seven") << 7 << 3;
+    QTest::newRow("eight") << 8 << 4;
+    QTest::newRow("many") << 14 << 4;
+}
+
+void tst_framestatistics::histogramBuckets()
+{
+    QFETCH(int, missedFrames);
+    QFETCH(int, bucket);
+
+    QCOMPARE(FrameStatistics::bucket(missedFrames), bucket);
+}
+
+void tst_framestatistics::idleGap()
+{
+    FrameStatistics statistics;
+    statistics.addFrame(0);
+    statistics.addFrame(FRAME);
+    // Nothing to render for a second, not a long frame.
+    statistics.addFrame(FRAME + 1000000000);
+    statistics.addFrame(2 * FRAME + 1000000000);
+
+    QCOMPARE(statistics.frames(), quint64(4));
+    QCOMPARE(statistics.droppedFrames(), quint64(0));
+    QCOMPARE(statistics.maximumInterval(), FRAME);
+}
+
+void tst_framestatistics::interrupt()
+{
+    FrameStatistics statistics;
+    statistics.addFrame(0);
+    statistics.addFrame(FRAME);
+    // The motion ended, the caret blinked 100 ms later.
+    statistics.interrupt();
+    statistics.addFrame(FRAME + 100000000);
+    statistics.addFrame(2 * FRAME + 100000000);
+
+    QCOMPARE(statistics.frames(), quint64(4));
+    QCOMPARE(statistics.droppedFrames(), quint64(0));
+    QCOMPARE(statistics.histogram(0), quint64(2));
+    QCOMPARE(statistics.maximumInterval(), FRAME);
+}
+
+void tst_framestatistics::checkerboardTime()
+{
+    FrameStatistics statistics;
+    statistics.addFrame(0, true);
+    statistics.addFrame(FRAME, true);
+    statistics.addFrame(2 * FRAME, true);
+    statistics.addFrame(3 * FRAME, false);
+
+    QCOMPARE(statistics.checkerboardTime(), 2 * FRAME);
+
+    statistics.reset();
+    QCOMPARE(statistics.frames(), quint64(0));
+    QCOMPARE(statistics.checkerboardTime(), qint64(0));
+}
+
+void tst_framestatistics::variantMap()
+{
+    FrameStatistics statistics;
+    statistics.addFrame(0);
+    statistics.addFrame(FRAME);
+    statistics.addFrame(10 * FRAME);
+
+    const QVariantMap map = statistics.toVariantMap();
+    QCOMPARE(map.value(QStringLiteral("frames")).toInt(), 3);
+    QCOMPARE(map.value(QStringLiteral("droppedFrames")).toInt(), 8);
+    QVERIFY(qAbs(map.value(QStringLiteral("maximumFrameInterval")).toReal() - 150.0) < 0.01);
+
+    const QVariantList histogram = map.value(QStringLiteral("jankHistogram")).toList();
+    QCOMPARE(histogram.count(), int(FrameStatistics::HistogramBuckets));
+    QCOMPARE(histogram.at(0).toInt(), 1);
+    QCOMPARE(histogram.at(4).toInt(), 1);
+}
+
+QTEST_MAIN(tst_framestatistics)
+#include "tst_framestatistics.moc"
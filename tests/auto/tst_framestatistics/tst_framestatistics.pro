@@ -0,0 +1,14 @@
+TARGET = tst_framestatistics
+
+include(../test_common.pri)
+
+QT -= gui
+
+target.path = /opt/tests/sailfish-components-webview/auto
+INSTALLS += target
+
+INCLUDEPATH += ../../../import/webview
+
+HEADERS += ../../../import/webview/framestatistics.h
+SOURCES += tst_framestatistics.cpp \
+           ../../../import/webview/framestatistics.cpp
@@ -0,0 +1,73 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "geckotranslations.h"
+
+#include <QtTest>
+
+using SailfishOS::WebView::Popups::GeckoTranslations;
+
+class tst_geckotranslations : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void translationId_data();
+    void translationId();
+    void translate();
+
+private:
+    // The conversion StringUtils.js used to do.
+    static QByteArray regExpTranslationId(const QString &key);
+};
+
+QByteArray tst_geckotranslations::regExpTranslationId(const QString &key)
+{
+    QString snake = key;
+    snake.replace(QRegularExpression("([a-z\\d]+)([A-Z])"), "\\1_\\2");
+    return "sailfish_components_webview_popups-la-" + snake.toLower().toUtf8();
+}
+
+void tst_geckotranslations::translationId_data()
+{
+    QTest::addColumn<QString>("key");
+
+    // In the generated table
+    QTest::newRow("Alert") << "Alert";
+    QTest::newRow("ConfirmCheck") << "ConfirmCheck";
+    QTest::newRow("PromptUsernameAndPassword3") << "PromptUsernameAndPassword3";
+    QTest::newRow("saveLoginMsgNoUser2") << "saveLoginMsgNoUser2";
+    QTest::newRow("rememberPassword") << "rememberPassword";
+    // Not in the table
+    QTest::newRow("unknownKey") << "unknownKey";
+    QTest::newRow("ABCdef") << "ABCdef";
+    QTest::newRow("a1B2cD") << "a1B2cD";
+    QTest::newRow("already translated") << "Already translated text.";
+}
+
+void tst_geckotranslations::translationId()
+{
+    QFETCH(QString, key);
+    QCOMPARE(GeckoTranslations::translationId(key), regExpTranslationId(key));
+}
+
+void tst_geckotranslations::translate()
+{
+    GeckoTranslations translations;
+
+    // No translations are installed, keys come back as such.
+    QCOMPARE(translations.translate(QStringLiteral("Alert")), QStringLiteral("Alert"));
+    QCOMPARE(translations.translate(QString()), QString());
+    QCOMPARE(translations.translate(QVariantList() << "Saved %1 for %2" << "password" << 3),
+             QStringLiteral("Saved password for 3"));
+}
+
+QTEST_MAIN(tst_geckotranslations)
+#include "tst_geckotranslations.moc"
@@ -0,0 +1,12 @@
+TARGET = tst_geckotranslations
+
+include(../test_common.pri)
+
+target.path = /opt/tests/sailfish-components-webview/auto
+INSTALLS += target
+
+INCLUDEPATH += ../../../import/popups
+
+HEADERS += ../../../import/popups/geckotranslations.h
+SOURCES += tst_geckotranslations.cpp \
+           ../../../import/popups/geckotranslations.cpp
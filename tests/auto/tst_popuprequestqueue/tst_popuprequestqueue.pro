@@ -0,0 +1,14 @@
+include(../../../defaults.pri)
+TARGET = tst_popuprequestqueue
+
+include(../test_common.pri)
+
+CONFIG += qmltestcase
+
+target.path = /opt/tests/sailfish-components-webview/auto
+qml.path = $$target.path
+qml.files = tst_popuprequestqueue.qml
+INSTALLS += target qml
+
+SOURCES += tst_popuprequestqueue.cpp
+OTHER_FILES += tst_popuprequestqueue.qml
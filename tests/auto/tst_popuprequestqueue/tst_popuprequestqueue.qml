@@ -0,0 +1,229 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+import QtQuick 2.0
+import QtTest 1.0
+import Sailfish.WebView.Popups 1.0
+
+TestCase {
+    id: testCase
+
+    name: "PopupRequestQueue"
+
+    property var shown: []
+    property var dropped: []
+
+    Component {
+        id: queueComponent
+
+        PopupRequestQueue {
+            originRateLimit: 3
+            originRateInterval: 60000
+            onRequestReady: testCase.shown.push(request)
+            onRequestDropped: testCase.dropped.push(request)
+        }
+    }
+
+    function request(topic, origin, text) {
+        return { "topic": topic, "origin": origin, "key": text }
+    }
+
+    // Replays a burst of messages as they would arrive from the content process.
+    function replay(queue, messages) {
+        for (var i = 0; i < messages.length; ++i) {
+            queue.enqueue(messages[i])
+        }
+    }
+
+    function init() {
+        shown = []
+        dropped = []
+    }
+
+    function test_coalesceIdenticalBurst() {
+        var queue = queueComponent.createObject(testCase)
+        var messages = []
+        for (var i = 0; i < 10; ++i) {
+            messages.push(request("embed:alert", "https://example.com", "spam"))
+        }
+        replay(queue, messages)
+
+        compare(shown.length, 1)
+        compare(shown[0].duplicates.length, 9)
+        compare(dropped.length, 0)
+        compare(queue.count, 0)
+
+        queue.finish(shown[0])
+        compare(shown.length, 1)
+        verify(!queue.busy)
+        queue.destroy()
+    }
+
+    function test_distinctRequestsAreQueuedInOrder() {
+        var queue = queueComponent.createObject(testCase)
+        replay(queue, [
+            request("embed:alert", "https://a.example", "first"),
+            request("embed:confirm", "https://b.example", "second"),
+            request("embed:alert", "https://c.example", "third")
+        ])
+
+        compare(shown.length, 1)
+        compare(queue.count, 2)
+        compare(shown[0].key, "first")
+
+        queue.finish(shown[0])
+        compare(shown.length, 2)
+        compare(shown[1].key, "second")
+
+        // Finishing a request that is not shown has no effect.
+        queue.finish(shown[0])
+        compare(shown.length, 2)
+
+        queue.finish(shown[1])
+        compare(shown[2].key, "third")
+        compare(queue.count, 0)
+        queue.destroy()
+    }
+
+    function test_sameTextDifferentTopicIsNotCoalesced() {
+        var queue = queueComponent.createObject(testCase)
+        replay(queue, [
+            request("embed:alert", "https://a.example", "text"),
+            request("embed:confirm", "https://a.example", "text")
+        ])
+
+        compare(shown.length, 1)
+        compare(shown[0].duplicates.length, 0)
+        compare(queue.count, 1)
+        queue.destroy()
+    }
+
+    function test_rateLimitPerOrigin() {
+        var queue = queueComponent.createObject(testCase)
+        var messages = []
+        for (var i = 0; i < 5; ++i) {
+            messages.push(request("embed:alert", "https://spam.example", "alert " + i))
+        }
+        messages.push(request("embed:alert", "https://other.example", "other"))
+        replay(queue, messages)
+
+        compare(dropped.length, 2)
+        compare(dropped[0].key, "alert 3")
+        compare(dropped[1].key, "alert 4")
+        // One shown and two from spam.example plus the other origin waiting
+        compare(shown.length, 1)
+        compare(queue.count, 3)
+        queue.destroy()
+    }
+
+    function test_maximumLength() {
+        var queue = queueComponent.createObject(testCase, { "originRateLimit": 0, "maximumLength": 2 })
+        replay(queue, [
+            request("embed:alert", "https://a.example", "1"),
+            request("embed:alert", "https://a.example", "2"),
+            request("embed:alert", "https://a.example", "3"),
+            request("embed:alert", "https://a.example", "4")
+        ])
+
+        compare(shown.length, 1)
+        compare(queue.count, 2)
+        compare(dropped.length, 1)
+        compare(dropped[0].key, "4")
+        queue.destroy()
+    }
+
+    function test_clearDropsPending() {
+        var queue = queueComponent.createObject(testCase)
+        replay(queue, [
+            request("embed:alert", "https://a.example", "1"),
+            request("embed:alert", "https://b.example", "2"),
+            request("embed:alert", "https://b.example", "2"),
+            request("embed:alert", "https://c.example", "3")
+        ])
+
+        queue.clear()
+        compare(queue.count, 0)
+        compare(dropped.length, 2)
+        compare(dropped[0].duplicates.length, 1)
+        verify(queue.busy)
+        queue.destroy()
+    }
+
+    function test_abortDropsShownAndForgetsOrigins() {
+        var queue = queueComponent.createObject(testCase)
+        replay(queue, [
+            request("embed:alert", "https://a.example", "1"),
+            request("embed:alert", "https://a.example", "2"),
+            request("embed:alert", "https://a.example", "3")
+        ])
+
+        queue.abort()
+        compare(queue.count, 0)
+        verify(!queue.busy)
+        compare(dropped.length, 3)
+        compare(dropped[2].key, "1")
+
+        // The rate limit starts over for the next page.
+        queue.enqueue(request("embed:alert", "https://a.example", "4"))
+        compare(shown.length, 2)
+        compare(dropped.length, 3)
+        queue.destroy()
+    }
+
+    Component {
+        id: popupComponent
+
+        Item {}
+    }
+
+    function test_destroyedPopupDropsShown() {
+        var queue = queueComponent.createObject(testCase)
+        replay(queue, [
+            request("embed:alert", "https://a.example", "1"),
+            request("embed:alert", "https://b.example", "2")
+        ])
+
+        var popup = popupComponent.createObject(testCase)
+        queue.opened(shown[0], popup)
+        popup.destroy()
+        tryCompare(dropped, "length", 1)
+        compare(dropped[0].key, "1")
+        compare(shown.length, 2)
+        compare(shown[1].key, "2")
+
+        // An answered popup that is destroyed afterwards drops nothing.
+        popup = popupComponent.createObject(testCase)
+        queue.opened(shown[1], popup)
+        queue.finish(shown[1])
+        popup.destroy()
+        wait(0)
+        compare(dropped.length, 1)
+        verify(!queue.busy)
+        queue.destroy()
+    }
+
+    function test_popupNotOpenedInTime() {
+        var queue = queueComponent.createObject(testCase, { "openTimeout": 50 })
+        replay(queue, [
+            request("embed:alert", "https://a.example", "1"),
+            request("embed:alert", "https://b.example", "2")
+        ])
+
+        tryCompare(dropped, "length", 1)
+        compare(dropped[0].key, "1")
+        compare(shown.length, 2)
+
+        queue.opened(shown[1], popupComponent.createObject(testCase))
+        wait(100)
+        compare(dropped.length, 1)
+        verify(queue.busy)
+        queue.destroy()
+    }
+}
@@ -0,0 +1,177 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "selectmodel.h"
+
+#include <QtTest>
+
+using SailfishOS::WebView::Pickers::SelectModel;
+
+class tst_selectmodel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void options();
+    void singleSelection();
+    void multipleSelection();
+    void filter();
+    void narrowingFilter();
+    void asyncFilter();
+
+private:
+    // Options as in an embed:select payload.
+    static QVariantList optionList(int count, int selected = -1);
+    static QStringList labels(const SelectModel &model);
+};
+
+QVariantList tst_selectmodel::optionList(int count, int selected)
+{
+    QVariantList options;
+    for (int i = 0; i < count; ++i) {
+        QVariantMap option;
+        option.insert("label", QStringLiteral("Option %1").arg(i));
+        option.insert("group", i < count / 2 ? QStringLiteral("first") : QStringLiteral("second"));
+        option.insert("index", i);
+        option.insert("selected", i == selected);
+        option.insert("disabled", false);
+        options.append(option);
+    }
+    return options;
+}
+
+QStringList tst_selectmodel::labels(const SelectModel &model)
+{
+    QStringList labels;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        labels.append(model.data(model.index(row), SelectModel::Label).toString());
+    }
+    return labels;
+}
+
+void tst_selectmodel::options()
+{
+    SelectModel model;
+    QSignalSpy countSpy(&model, &SelectModel::countChanged);
+    model.setOptions(optionList(10, 3));
+
+    QCOMPARE(model.rowCount(), 10);
+    QCOMPARE(model.optionCount(), 10);
+    QCOMPARE(countSpy.count(), 1);
+    QCOMPARE(model.data(model.index(4), SelectModel::Label).toString(), QStringLiteral("Option 4"));
+    QCOMPARE(model.data(model.index(7), SelectModel::Group).toString(), QStringLiteral("second"));
+    QCOMPARE(model.data(model.index(4), SelectModel::OptionIndex).toInt(), 4);
+    QVERIFY(model.data(model.index(3), SelectModel::Selected).toBool());
+    QCOMPARE(model.selectedRow(), 3);
+    QCOMPARE(model.selectedIndexes(), QList<int>() << 3);
+
+    // Nothing changed yet.
+    QVERIFY(model.result().isEmpty());
+}
+
+void tst_selectmodel::singleSelection()
+{
+    SelectModel model;
+    model.setOptions(optionList(10, 3));
+
+    QSignalSpy dataSpy(&model, &SelectModel::dataChanged);
+    model.select(6);
+    QCOMPARE(dataSpy.count(), 2);
+    QCOMPARE(model.selectedIndexes(), QList<int>() << 6);
+
+    // Only the changed options are sent back.
+    const QVariantList result = model.result();
+    QCOMPARE(result.count(), 2);
+    QCOMPARE(result.at(0).toMap().value("index").toInt(), 3);
+    QCOMPARE(result.at(0).toMap().value("selected").toBool(), false);
+    QCOMPARE(result.at(1).toMap().value("index").toInt(), 6);
+    QCOMPARE(result.at(1).toMap().value("selected").toBool(), true);
+
+    model.select(3);
+    QVERIFY(model.result().isEmpty());
+}
+
+void tst_selectmodel::multipleSelection()
+{
+    SelectModel model;
+    model.setMultiple(true);
+    model.setOptions(optionList(10, 3));
+
+    model.toggle(5);
+    model.toggle(8);
+    model.toggle(3);
+    QCOMPARE(model.selectedIndexes(), QList<int>() << 5 << 8);
+    QCOMPARE(model.result().count(), 3);
+
+    model.toggle(5);
+    QCOMPARE(model.selectedIndexes(), QList<int>() << 8);
+}
+
+void tst_selectmodel::filter()
+{
+    SelectModel model;
+    model.setOptions(optionList(30));
+
+    model.setFilter(QStringLiteral("option 2"));
+    QVERIFY(!model.filtering());
+    QCOMPARE(model.rowCount(), 11);
+    QCOMPARE(labels(model).first(), QStringLiteral("Option 2"));
+
+    // Rows refer to the filtered options.
+    model.select(1);
+    QCOMPARE(model.selectedIndexes(), QList<int>() << 20);
+
+    model.setFilter(QString());
+    QCOMPARE(model.rowCount(), 30);
+    QCOMPARE(model.selectedRow(), 20);
+
+    model.setFilter(QStringLiteral("nothing"));
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.selectedRow(), -1);
+}
+
+void tst_selectmodel::narrowingFilter()
+{
+    SelectModel model;
+    model.setOptions(optionList(300));
+
+    model.setFilter(QStringLiteral("1"));
+    const int ones = model.rowCount();
+    model.setFilter(QStringLiteral("12"));
+    QCOMPARE(labels(model), QStringList() << "Option 12" << "Option 112" << "Option 120"
+             << "Option 121" << "Option 122" << "Option 123" << "Option 124" << "Option 125"
+             << "Option 126" << "Option 127" << "Option 128" << "Option 129" << "Option 212");
+
+    // Widening starts over from all options.
+    model.setFilter(QStringLiteral("1"));
+    QCOMPARE(model.rowCount(), ones);
+}
+
+void tst_selectmodel::asyncFilter()
+{
+    SelectModel model;
+    model.setOptions(optionList(SelectModel::AsyncFilterThreshold * 2));
+
+    QSignalSpy filteringSpy(&model, &SelectModel::filteringChanged);
+    model.setFilter(QStringLiteral("option 3"));
+    QVERIFY(model.filtering());
+    // Only the last of quickly typed filters is applied.
+    model.setFilter(QStringLiteral("option 39"));
+    QVERIFY(model.filtering());
+
+    QTRY_VERIFY(!model.filtering());
+    QCOMPARE(filteringSpy.count(), 2);
+    // 39, 390 - 399 and 3900 - 3999
+    QCOMPARE(model.rowCount(), 111);
+    QCOMPARE(labels(model).first(), QStringLiteral("Option 39"));
+}
+
+QTEST_MAIN(tst_selectmodel)
+#include "tst_selectmodel.moc"
@@ -0,0 +1,12 @@
+TARGET = tst_selectmodel
+
+include(../test_common.pri)
+
+target.path = /opt/tests/sailfish-components-webview/auto
+INSTALLS += target
+
+INCLUDEPATH += ../../../import/pickers
+
+HEADERS += ../../../import/pickers/selectmodel.h
+SOURCES += tst_selectmodel.cpp \
+           ../../../import/pickers/selectmodel.cpp
@@ -0,0 +1,197 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "textselectiongeometry.h"
+
+#include <QtTest>
+#include <QQuickItem>
+
+// Provides the QuickMozView properties the geometry reads.
+class FakeContentItem : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QPointF scrollableOffset READ scrollableOffset NOTIFY scrollableOffsetChanged)
+    Q_PROPERTY(qreal resolution READ resolution NOTIFY resolutionChanged)
+
+public:
+    QPointF scrollableOffset() const { return m_scrollableOffset; }
+    void setScrollableOffset(const QPointF &offset)
+    {
+        m_scrollableOffset = offset;
+        emit scrollableOffsetChanged();
+    }
+
+    qreal resolution() const { return m_resolution; }
+    void setResolution(qreal resolution)
+    {
+        m_resolution = resolution;
+        emit resolutionChanged();
+    }
+
+signals:
+    void scrollableOffsetChanged();
+    void resolutionChanged();
+
+private:
+    QPointF m_scrollableOffset;
+    qreal m_resolution = 1.0;
+};
+
+static QVariantMap cssPosition(qreal x, qreal y)
+{
+    QVariantMap position;
+    position.insert(QStringLiteral("xPos"), x);
+    position.insert(QStringLiteral("yPos"), y);
+    position.insert(QStringLiteral("height"), 16);
+    return position;
+}
+
+static QVariantMap selectionRange()
+{
+    QVariantMap visualViewport;
+    visualViewport.insert(QStringLiteral("offsetLeft"), 10);
+    visualViewport.insert(QStringLiteral("offsetTop"), 20);
+
+    QVariantMap data;
+    data.insert(QStringLiteral("start"), cssPosition(110, 220));
+    data.insert(QStringLiteral("end"), cssPosition(210, 240));
+    data.insert(QStringLiteral("visualViewport"), visualViewport);
+    return data;
+}
+
+class tst_textselectiongeometry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void fixedPositions();
+    void followsPanAndZoom();
+    void lockedHandleKeepsPosition();
+    void markerMessageRoundTrip();
+    void requestFrameCoalesces();
+
+private:
+    FakeContentItem *content;
+    QQuickItem *startHandle;
+    QQuickItem *endHandle;
+    TextSelectionGeometry *geometry;
+};
+
+void tst_textselectiongeometry::init()
+{
+    content = new FakeContentItem;
+    startHandle = new QQuickItem;
+    startHandle->setSize(QSizeF(20, 20));
+    startHandle->setProperty("fixedX", 0.0);
+    startHandle->setProperty("fixedY", 0.0);
+    endHandle = new QQuickItem;
+    endHandle->setSize(QSizeF(20, 20));
+    endHandle->setProperty("fixedX", 0.0);
+    endHandle->setProperty("fixedY", 0.0);
+
+    geometry = new TextSelectionGeometry;
+    geometry->setContentItem(content);
+    geometry->setStartHandle(startHandle);
+    geometry->setEndHandle(endHandle);
+}
+
+void tst_textselectiongeometry::cleanup()
+{
+    delete geometry;
+    delete startHandle;
+    delete endHandle;
+    delete content;
+}
+
+void tst_textselectiongeometry::fixedPositions()
+{
+    content->setResolution(2.0);
+    geometry->setSelectionRange(selectionRange());
+
+    QVERIFY(geometry->hasSelection());
+    QCOMPARE(startHandle->property("fixedX").toReal(), 180.0);
+    QCOMPARE(startHandle->property("fixedY").toReal(), 400.0);
+    QCOMPARE(endHandle->property("fixedX").toReal(), 400.0);
+    QCOMPARE(endHandle->property("fixedY").toReal(), 440.0);
+
+    geometry->clear();
+    QVERIFY(!geometry->hasSelection());
+}
+
+void tst_textselectiongeometry::followsPanAndZoom()
+{
+    geometry->setSelectionRange(selectionRange());
+    geometry->updateHandlePositions();
+    QCOMPARE(startHandle->position(), QPointF(80, 200));
+    QCOMPARE(endHandle->position(), QPointF(200, 220));
+
+    content->setScrollableOffset(QPointF(30, 50));
+    geometry->updateHandlePositions();
+    QCOMPARE(startHandle->position(), QPointF(50, 150));
+    QCOMPARE(endHandle->position(), QPointF(170, 170));
+
+    content->setResolution(0.5);
+    geometry->updateHandlePositions();
+    QCOMPARE(startHandle->position(), QPointF(15, 75));
+    QCOMPARE(endHandle->position(), QPointF(85, 85));
+}
+
+void tst_textselectiongeometry::lockedHandleKeepsPosition()
+{
+    geometry->setSelectionRange(selectionRange());
+    geometry->updateHandlePositions();
+
+    startHandle->setProperty("positionLocked", true);
+    content->setScrollableOffset(QPointF(0, 100));
+    geometry->updateHandlePositions();
+
+    QCOMPARE(startHandle->position(), QPointF(80, 200));
+    QCOMPARE(startHandle->property("fixedY").toReal(), 100.0);
+    QCOMPARE(endHandle->position(), QPointF(200, 120));
+}
+
+void tst_textselectiongeometry::markerMessageRoundTrip()
+{
+    content->setResolution(1.5);
+    content->setScrollableOffset(QPointF(5, 5));
+    geometry->setSelectionRange(selectionRange());
+    content->setScrollableOffset(QPointF(45, 25));
+    geometry->updateHandlePositions();
+
+    const QVariantMap message = geometry->markerMessage(QStringLiteral("end"));
+    QCOMPARE(message.value(QStringLiteral("change")).toString(), QStringLiteral("end"));
+    const QVariantMap start = message.value(QStringLiteral("start")).toMap();
+    const QVariantMap end = message.value(QStringLiteral("end")).toMap();
+    QCOMPARE(start.value(QStringLiteral("xPos")).toReal(), 110.0);
+    QCOMPARE(start.value(QStringLiteral("yPos")).toReal(), 220.0);
+    QCOMPARE(end.value(QStringLiteral("xPos")).toReal(), 210.0);
+    QCOMPARE(end.value(QStringLiteral("yPos")).toReal(), 240.0);
+}
+
+void tst_textselectiongeometry::requestFrameCoalesces()
+{
+    QSignalSpy frameSpy(geometry, SIGNAL(frame()));
+    geometry->requestFrame();
+    geometry->requestFrame();
+    QCOMPARE(frameSpy.count(), 0);
+
+    QTRY_COMPARE(frameSpy.count(), 1);
+    QTest::qWait(20);
+    QCOMPARE(frameSpy.count(), 1);
+
+    geometry->requestFrame();
+    QTRY_COMPARE(frameSpy.count(), 2);
+}
+
+QTEST_MAIN(tst_textselectiongeometry)
+#include "tst_textselectiongeometry.moc"
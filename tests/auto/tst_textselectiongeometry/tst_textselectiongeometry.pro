@@ -0,0 +1,14 @@
+TARGET = tst_textselectiongeometry
+
+include(../test_common.pri)
+
+QT += quick
+
+target.path = /opt/tests/sailfish-components-webview/auto
+INSTALLS += target
+
+INCLUDEPATH += ../../../import/controls
+
+HEADERS += ../../../import/controls/textselectiongeometry.h
+SOURCES += tst_textselectiongeometry.cpp \
+           ../../../import/controls/textselectiongeometry.cpp
@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "translationregistry.h"
+
+#include <QtTest>
+
+using SailfishOS::TranslationRegistry;
+
+static const QString TEST_DIRECTORY = QStringLiteral("/nonexistent");
+
+class tst_translationregistry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lazyLoad();
+    void sharedCatalog();
+    void releasedWithOwner();
+    void sharedIds();
+    void unmatchedLookup();
+};
+
+void tst_translationregistry::lazyLoad()
+{
+    QObject owner;
+    TranslationRegistry *registry = TranslationRegistry::instance();
+    registry->addCatalog(&owner, QStringLiteral("popups"),
+                         QStringList() << QStringLiteral("test_popups-"), TEST_DIRECTORY);
+    registry->addCatalog(&owner, QStringLiteral("pickers"),
+                         QStringList() << QStringLiteral("test_pickers-"), TEST_DIRECTORY);
+
+    // Nothing is loaded before a string of the catalog is needed.
+    QVERIFY(registry->loadedCatalogs().isEmpty());
+    QVERIFY(!registry->isEmpty());
+
+    // Missing translations fall back to the id.
+    QCOMPARE(qtTrId("test_pickers-la-title"), QStringLiteral("test_pickers-la-title"));
+    QCOMPARE(registry->loadedCatalogs(), QStringList() << QStringLiteral("pickers"));
+
+    qtTrId("test_pickers-la-other");
+    QCOMPARE(registry->loadedCatalogs(), QStringList() << QStringLiteral("pickers"));
+}
+
+void tst_translationregistry::sharedCatalog()
+{
+    TranslationRegistry *registry = TranslationRegistry::instance();
+    QScopedPointer<QObject> first(new QObject);
+    QScopedPointer<QObject> second(new QObject);
+    registry->addCatalog(first.data(), QStringLiteral("shared"),
+                         QStringList() << QStringLiteral("test_shared-"), TEST_DIRECTORY);
+    registry->addCatalog(second.data(), QStringLiteral("shared"),
+                         QStringList() << QStringLiteral("test_shared-"), TEST_DIRECTORY);
+
+    qtTrId("test_shared-la-title");
+    QCOMPARE(registry->loadedCatalogs(), QStringList() << QStringLiteral("shared"));
+
+    // Still used by the second engine.
+    first.reset();
+    QCOMPARE(registry->loadedCatalogs(), QStringList() << QStringLiteral("shared"));
+
+    second.reset();
+    QVERIFY(registry->loadedCatalogs().isEmpty());
+}
+
+void tst_translationregistry::releasedWithOwner()
+{
+    TranslationRegistry *registry = TranslationRegistry::instance();
+    {
+        QObject owner;
+        registry->addCatalog(&owner, QStringLiteral("controls"),
+                             QStringList() << QStringLiteral("test_controls-"), TEST_DIRECTORY);
+        qtTrId("test_controls-la-copied");
+        QCOMPARE(registry->loadedCatalogs(), QStringList() << QStringLiteral("controls"));
+    }
+
+    QVERIFY(registry->isEmpty());
+    QVERIFY(registry->loadedCatalogs().isEmpty());
+}
+
+void tst_translationregistry::sharedIds()
+{
+    QObject owner;
+    TranslationRegistry *registry = TranslationRegistry::instance();
+    registry->addCatalog(&owner, QStringLiteral("popups"),
+                         QStringList() << QStringLiteral("test_popups-"), TEST_DIRECTORY);
+    registry->addCatalogIds(QStringLiteral("popups"), QStringList() << QStringLiteral("test_browser-he-share"));
+
+    // Other strings of the browser don't load the catalog.
+    qtTrId("test_browser-he-tabs");
+    qtTrId("test_browser-he-share_link");
+    QVERIFY(registry->loadedCatalogs().isEmpty());
+
+    qtTrId("test_browser-he-share");
+    QCOMPARE(registry->loadedCatalogs(), QStringList() << QStringLiteral("popups"));
+}
+
+void tst_translationregistry::unmatchedLookup()
+{
+    QObject owner;
+    TranslationRegistry *registry = TranslationRegistry::instance();
+    registry->addCatalog(&owner, QStringLiteral("popups"),
+                         QStringList() << QStringLiteral("test_popups-"), TEST_DIRECTORY);
+
+    QCOMPARE(registry->translate(nullptr, "other-la-title"), QString());
+    QVERIFY(registry->loadedCatalogs().isEmpty());
+}
+
+QTEST_MAIN(tst_translationregistry)
+#include "tst_translationregistry.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+SUBDIRS += catalogmatch \
+           fileprepare \
+           flickstress \
+           framerecording \
+           geckostrings \
+           qmlstartup \
+           selectionpan \
+           selectoptions
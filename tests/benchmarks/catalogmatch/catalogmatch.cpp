@@ -0,0 +1,47 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Measures TranslationRegistry::translate() for ids that belong to no
+// registered catalog, which is the cost every other qtTrId() call of the
+// application pays once the registry is installed.
+
+#include "translationregistry.h"
+
+#include <QtTest>
+
+using SailfishOS::TranslationRegistry;
+
+static const QString TEST_DIRECTORY = QStringLiteral("/nonexistent");
+
+class CatalogMatch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void unmatchedLookup();
+};
+
+void CatalogMatch::unmatchedLookup()
+{
+    QObject owner;
+    TranslationRegistry *registry = TranslationRegistry::instance();
+    registry->addCatalog(&owner, QStringLiteral("popups"),
+                         QStringList() << QStringLiteral("test_popups-"), TEST_DIRECTORY);
+    registry->addCatalog(&owner, QStringLiteral("pickers"),
+                         QStringList() << QStringLiteral("test_pickers-"), TEST_DIRECTORY);
+    registry->addCatalogIds(QStringLiteral("popups"), QStringList() << QStringLiteral("test_browser-he-share"));
+
+    QBENCHMARK {
+        registry->translate(nullptr, "other-la-title");
+    }
+}
+
+QTEST_MAIN(CatalogMatch)
+#include "catalogmatch.moc"
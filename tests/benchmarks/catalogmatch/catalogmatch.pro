@@ -0,0 +1,18 @@
+TEMPLATE = app
+TARGET = catalogmatch
+
+include(../../../defaults.pri)
+
+QT += testlib
+QT -= gui
+
+CONFIG += link_pkgconfig
+PKGCONFIG += qt5embedwidget
+
+target.path = /opt/tests/sailfish-components-webview/benchmarks
+INSTALLS += target
+
+INCLUDEPATH += ../../../lib
+LIBS += -L../../../lib -lsailfishwebengine
+
+SOURCES += catalogmatch.cpp
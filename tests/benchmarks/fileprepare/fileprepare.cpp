@@ -0,0 +1,55 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Measures FileHandoff preparing a batch of picked files for upload, with
+// file descriptors, from the request to the finished signal.
+
+#include "filehandoff.h"
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+using SailfishOS::WebView::Pickers::FileHandoff;
+
+class FilePrepare : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void prepare();
+};
+
+void FilePrepare::prepare()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QStringList files;
+    for (int i = 0; i < 200; ++i) {
+        QFile file(dir.filePath(QStringLiteral("upload%1.jpg").arg(i)));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(1024, 'x'));
+        files.append(file.fileName());
+    }
+
+    FileHandoff handoff;
+    handoff.setFileDescriptors(true);
+    QSignalSpy finishedSpy(&handoff, &FileHandoff::finished);
+
+    QBENCHMARK {
+        finishedSpy.clear();
+        handoff.prepare(files);
+        QTRY_COMPARE(finishedSpy.count(), 1);
+        FileHandoff::closeFileDescriptors(finishedSpy.first().first().toList());
+    }
+}
+
+QTEST_MAIN(FilePrepare)
+#include "fileprepare.moc"
@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = fileprepare
+
+include(../../../defaults.pri)
+
+QT += testlib
+
+target.path = /opt/tests/sailfish-components-webview/benchmarks
+INSTALLS += target
+
+INCLUDEPATH += ../../../import/pickers
+
+HEADERS += ../../../import/pickers/filehandoff.h
+SOURCES += fileprepare.cpp \
+           ../../../import/pickers/filehandoff.cpp
@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <QtTest>
+#include <QtGui/qpa/qwindowsysteminterface.h>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickView>
+
+// Fast flicks over a long page with progressive painting and low precision
+// buffers enabled, to be run by hand on a device. QmlMozView crashes in
+// this scenario for a yet unknown reason, which is why the WebView plugin
+// disables them unless SAILFISH_WEBVIEW_PROGRESSIVE_PAINT is set. The crash
+// has no known reproduction, so surviving a run is not proof that it is
+// fixed.
+
+static const int FLICK_COUNT = 200;
+static const int FLICK_STEPS = 4;
+
+class FlickStress : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void fastFlicks();
+    void snapshotsWhileFlicking();
+
+private:
+    void flick(int index);
+    QUrl longPage() const;
+
+    QQuickView *m_window = nullptr;
+    QQuickItem *m_webView = nullptr;
+    QTouchDevice *m_device = nullptr;
+};
+
+void FlickStress::initTestCase()
+{
+    // Read by the WebView plugin when the QML module is loaded.
+    qputenv("SAILFISH_WEBVIEW_PROGRESSIVE_PAINT", "1");
+
+    m_device = new QTouchDevice;
+    m_device->setType(QTouchDevice::TouchScreen);
+    QWindowSystemInterface::registerTouchDevice(m_device);
+
+    m_window = new QQuickView;
+    m_window->setResizeMode(QQuickView::SizeRootObjectToView);
+    m_window->resize(540, 960);
+
+    QQmlComponent component(m_window->engine());
+    component.setData("import QtQuick 2.0\n"
+                      "import Sailfish.WebView 1.0\n"
+                      "RawWebView { active: true }\n", QUrl());
+    m_webView = qobject_cast<QQuickItem *>(component.create());
+    QVERIFY2(m_webView, qPrintable(component.errorString()));
+    m_webView->setParentItem(m_window->contentItem());
+    m_webView->setSize(QSizeF(m_window->width(), m_window->height()));
+
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window));
+
+    QMetaObject::invokeMethod(m_webView, "load", Q_ARG(QString, longPage().toString()));
+    QTRY_VERIFY_WITH_TIMEOUT(m_webView->property("loaded").toBool(), 30000);
+    QTRY_VERIFY_WITH_TIMEOUT(m_webView->property("contentHeight").toReal() > 10 * m_window->height(), 10000);
+}
+
+void FlickStress::cleanupTestCase()
+{
+    delete m_window;
+    m_window = nullptr;
+    m_webView = nullptr;
+}
+
+void FlickStress::fastFlicks()
+{
+    const QPointF start = m_webView->property("scrollableOffset").toPointF();
+    bool scrolled = false;
+
+    for (int i = 0; i < FLICK_COUNT; ++i) {
+        flick(i);
+        scrolled |= m_webView->property("scrollableOffset").toPointF() != start;
+    }
+
+    QVERIFY(scrolled);
+    // Let the last flings settle while progressive paints are still coming in.
+    QTest::qWait(2000);
+    QVERIFY(m_webView->property("loaded").toBool());
+}
+
+void FlickStress::snapshotsWhileFlicking()
+{
+    QSignalSpy snapshotSpy(m_webView, SIGNAL(snapshotUrlChanged()));
+
+    for (int i = 0; i < FLICK_COUNT / 4; ++i) {
+        if (i % 5 == 0) {
+            QMetaObject::invokeMethod(m_webView, "captureSnapshot", Q_ARG(qreal, 0.25));
+        }
+        flick(i);
+    }
+
+    QTRY_VERIFY(snapshotSpy.count() > 0);
+}
+
+// A short, fast swipe. The direction changes every 20 flicks so that the
+// page is scrolled back and forth over areas that need to be repainted.
+void FlickStress::flick(int index)
+{
+    const int x = m_window->width() / 2;
+    const int distance = m_window->height() / 2;
+    const int direction = (index / 20) % 2 == 0 ? -1 : 1;
+    QPoint position(x, m_window->height() / 2 - direction * distance / 2);
+
+    QTest::touchEvent(m_window, m_device).press(0, position, m_window);
+    for (int step = 0; step < FLICK_STEPS; ++step) {
+        QTest::qWait(8);
+        position.ry() += direction * distance / FLICK_STEPS;
+        QTest::touchEvent(m_window, m_device).move(0, position, m_window);
+    }
+    QTest::touchEvent(m_window, m_device).release(0, position, m_window);
+    QTest::qWait(16);
+}
+
+QUrl FlickStress::longPage() const
+{
+    QString html = QStringLiteral("<html><head><meta name=\"viewport\" content=\"width=device-width\"></head><body>");
+    for (int i = 0; i < 400; ++i) {
+        html += QStringLiteral("<div style=\"height:120px;background:hsl(%1,60%,50%)\"><p>Paragraph %2</p></div>")
+                .arg((i * 37) % 360).arg(i);
+    }
+    html += QStringLiteral("</body></html>");
+    return QUrl(QStringLiteral("data:text/html,") + QString::fromLatin1(QUrl::toPercentEncoding(html)));
+}
+
+QTEST_MAIN(FlickStress)
+#include "flickstress.moc"
@@ -0,0 +1,11 @@
+TEMPLATE = app
+TARGET = flickstress
+
+include(../../../defaults.pri)
+
+QT += testlib quick gui-private
+
+target.path = /opt/tests/sailfish-components-webview/benchmarks
+INSTALLS += target
+
+SOURCES += flickstress.cpp
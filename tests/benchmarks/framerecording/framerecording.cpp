@@ -0,0 +1,42 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Measures FrameStatistics::addFrame(), which runs on the render thread
+// once per presented frame while a view is instrumented and moves.
+
+#include "framestatistics.h"
+
+#include <QtTest>
+
+using SailfishOS::WebView::FrameStatistics;
+
+static const qint64 FRAME = 16666667;
+
+class FrameRecording : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void addFrame();
+};
+
+void FrameRecording::addFrame()
+{
+    FrameStatistics statistics;
+    qint64 timestamp = 0;
+
+    QBENCHMARK {
+        timestamp += FRAME;
+        statistics.addFrame(timestamp);
+    }
+}
+
+QTEST_MAIN(FrameRecording)
+#include "framerecording.moc"
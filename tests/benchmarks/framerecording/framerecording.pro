@@ -0,0 +1,16 @@
+TEMPLATE = app
+TARGET = framerecording
+
+include(../../../defaults.pri)
+
+QT += testlib
+QT -= gui
+
+target.path = /opt/tests/sailfish-components-webview/benchmarks
+INSTALLS += target
+
+INCLUDEPATH += ../../../import/webview
+
+HEADERS += ../../../import/webview/framestatistics.h
+SOURCES += framerecording.cpp \
+           ../../../import/webview/framestatistics.cpp
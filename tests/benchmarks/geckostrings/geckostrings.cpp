@@ -0,0 +1,39 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Measures GeckoTranslations::translate() for a message bundle of a gecko
+// popup, i.e. the table lookup of the key and the argument substitution.
+
+#include "geckotranslations.h"
+
+#include <QtTest>
+
+using SailfishOS::WebView::Popups::GeckoTranslations;
+
+class GeckoStrings : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void translate();
+};
+
+void GeckoStrings::translate()
+{
+    GeckoTranslations translations;
+    const QVariant bundle = QVariantList() << "PromptUsernameAndPassword3" << "example.com";
+
+    QBENCHMARK {
+        translations.translate(bundle);
+    }
+}
+
+QTEST_MAIN(GeckoStrings)
+#include "geckostrings.moc"
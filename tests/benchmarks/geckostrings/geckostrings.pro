@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = geckostrings
+
+include(../../../defaults.pri)
+
+QT += testlib
+
+target.path = /opt/tests/sailfish-components-webview/benchmarks
+INSTALLS += target
+
+INCLUDEPATH += ../../../import/popups
+
+HEADERS += ../../../import/popups/geckotranslations.h
+SOURCES += geckostrings.cpp \
+           ../../../import/popups/geckotranslations.cpp
@@ -0,0 +1,186 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Measures the time to the first WebView, to the first popup and to the
+// imports of all WebView modules in a fresh process. Each case runs with
+// the installed modules ("installed") and with a copy of them that has no
+// ahead-of-time compiled .qmlc and .jsc files ("absent"). Every run gets an
+// empty XDG_CACHE_HOME, so that the runtime disk cache written by earlier
+// runs is not used in either mode.
+//
+// Without the cache files installed, e.g. when built without --with
+// qmlcache, both modes measure the same thing.
+//
+// Usage: qmlstartup [runs]
+
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QLibraryInfo>
+#include <QtCore/QProcess>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
+#include <QtGui/QGuiApplication>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+
+#include <algorithm>
+
+namespace {
+
+struct Case
+{
+    const char *name;
+    const char *source;
+};
+
+const Case cases[] = {
+    { "webview", "import QtQuick 2.0\nimport Sailfish.WebView 1.0\nWebView {}\n" },
+    { "popup", "import QtQuick 2.0\nimport Sailfish.WebView.Popups 1.0\nAlertDialog {}\n" },
+    // A host application translating its own strings at startup, no
+    // WebView catalog should be loaded.
+    { "imports", "import QtQuick 2.0\n"
+                 "import Sailfish.WebView 1.0\n"
+                 "import Sailfish.WebView.Controls 1.0\n"
+                 "import Sailfish.WebView.Pickers 1.0\n"
+                 "import Sailfish.WebView.Popups 1.0\n"
+                 "QtObject { property string title: qsTrId(\"sailfish_browser-he-tabs\") }\n" }
+};
+
+const char childArgument[] = "--child";
+
+// Prints the microseconds from engine creation to the object being created.
+int runChild(int argc, char *argv[], const QByteArray &caseName)
+{
+    QGuiApplication app(argc, argv);
+
+    for (const Case &c : cases) {
+        if (caseName != c.name) {
+            continue;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QQmlEngine engine;
+        QQmlComponent component(&engine);
+        component.setData(c.source, QUrl());
+        QScopedPointer<QObject> object(component.create());
+        const qint64 elapsed = timer.nsecsElapsed() / 1000;
+
+        if (!object) {
+            QTextStream(stderr) << component.errorString();
+            return 1;
+        }
+
+        QTextStream(stdout) << elapsed << endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+qint64 median(QVector<qint64> values)
+{
+    std::sort(values.begin(), values.end());
+    return values.isEmpty() ? 0 : values.at(values.count() / 2);
+}
+
+bool isCacheFile(const QString &path)
+{
+    return path.endsWith(QLatin1String(".qmlc")) || path.endsWith(QLatin1String(".jsc"));
+}
+
+// Copies the installed WebView modules to target without the cache files,
+// returns the number of cache files left out or -1 on failure.
+int copyModulesWithoutCache(const QString &target)
+{
+    const QDir source(QLibraryInfo::location(QLibraryInfo::Qml2ImportsPath) + QStringLiteral("/Sailfish/WebView"));
+    if (!source.exists()) {
+        return -1;
+    }
+
+    int skipped = 0;
+    QDirIterator it(source.absolutePath(), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString file = it.next();
+        if (isCacheFile(file)) {
+            ++skipped;
+            continue;
+        }
+
+        const QString copy = target + QStringLiteral("/Sailfish/WebView/") + source.relativeFilePath(file);
+        if (!QDir().mkpath(QFileInfo(copy).absolutePath()) || !QFile::copy(file, copy)) {
+            return -1;
+        }
+    }
+    return skipped;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 3 && qstrcmp(argv[1], childArgument) == 0) {
+        return runChild(argc, argv, argv[2]);
+    }
+
+    QCoreApplication app(argc, argv);
+    const int runs = argc > 1 ? qMax(1, QByteArray(argv[1]).toInt()) : 10;
+
+    QTemporaryDir modules;
+    const int cacheFiles = modules.isValid() ? copyModulesWithoutCache(modules.path()) : -1;
+    if (cacheFiles < 0) {
+        QTextStream(stderr) << "Cannot copy the installed WebView modules" << endl;
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    out << "# " << cacheFiles << " installed .qmlc/.jsc files" << endl;
+    out << "case\tmode\tmedian_us\tmin_us\tmax_us" << endl;
+
+    for (const Case &c : cases) {
+        for (bool installed : { true, false }) {
+            QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+            if (!installed) {
+                // Takes precedence over the installed modules.
+                environment.insert(QStringLiteral("QML2_IMPORT_PATH"), modules.path());
+            }
+
+            QVector<qint64> times;
+            for (int i = 0; i < runs; ++i) {
+                // A runtime disk cache starts empty in every run.
+                QTemporaryDir cache;
+                environment.insert(QStringLiteral("XDG_CACHE_HOME"), cache.path());
+
+                QProcess child;
+                child.setProcessEnvironment(environment);
+                child.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+                child.start(QCoreApplication::applicationFilePath(),
+                            QStringList() << QLatin1String(childArgument) << QLatin1String(c.name));
+                if (!child.waitForFinished(60000) || child.exitCode() != 0) {
+                    QTextStream(stderr) << "Run of " << c.name << " failed" << endl;
+                    return 1;
+                }
+                times.append(child.readAllStandardOutput().trimmed().toLongLong());
+            }
+
+            out << c.name << '\t' << (installed ? "installed" : "absent") << '\t'
+                << median(times) << '\t'
+                << *std::min_element(times.constBegin(), times.constEnd()) << '\t'
+                << *std::max_element(times.constBegin(), times.constEnd()) << endl;
+        }
+    }
+
+    return 0;
+}
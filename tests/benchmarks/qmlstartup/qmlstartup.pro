@@ -0,0 +1,12 @@
+TEMPLATE = app
+TARGET = qmlstartup
+
+include(../../../defaults.pri)
+
+QT += gui qml quick
+QMAKE_CXXFLAGS += -fPIE
+
+target.path = /opt/tests/sailfish-components-webview/benchmarks
+INSTALLS += target
+
+SOURCES += main.cpp
@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Measures TextSelectionGeometry::updateHandlePositions() while the page
+// is panned under a selection, which runs once per frame.
+
+#include "textselectiongeometry.h"
+
+#include <QtTest>
+#include <QQuickItem>
+
+// Provides the QuickMozView properties the geometry reads.
+class FakeContentItem : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QPointF scrollableOffset READ scrollableOffset NOTIFY scrollableOffsetChanged)
+    Q_PROPERTY(qreal resolution READ resolution NOTIFY resolutionChanged)
+
+public:
+    QPointF scrollableOffset() const { return m_scrollableOffset; }
+    void setScrollableOffset(const QPointF &offset)
+    {
+        m_scrollableOffset = offset;
+        emit scrollableOffsetChanged();
+    }
+
+    qreal resolution() const { return m_resolution; }
+    void setResolution(qreal resolution)
+    {
+        m_resolution = resolution;
+        emit resolutionChanged();
+    }
+
+signals:
+    void scrollableOffsetChanged();
+    void resolutionChanged();
+
+private:
+    QPointF m_scrollableOffset;
+    qreal m_resolution = 1.0;
+};
+
+static QVariantMap cssPosition(qreal x, qreal y)
+{
+    QVariantMap position;
+    position.insert(QStringLiteral("xPos"), x);
+    position.insert(QStringLiteral("yPos"), y);
+    position.insert(QStringLiteral("height"), 16);
+    return position;
+}
+
+static QVariantMap selectionRange()
+{
+    QVariantMap visualViewport;
+    visualViewport.insert(QStringLiteral("offsetLeft"), 10);
+    visualViewport.insert(QStringLiteral("offsetTop"), 20);
+
+    QVariantMap data;
+    data.insert(QStringLiteral("start"), cssPosition(110, 220));
+    data.insert(QStringLiteral("end"), cssPosition(210, 240));
+    data.insert(QStringLiteral("visualViewport"), visualViewport);
+    return data;
+}
+
+class SelectionPan : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pan();
+};
+
+void SelectionPan::pan()
+{
+    FakeContentItem content;
+    QQuickItem startHandle;
+    startHandle.setSize(QSizeF(20, 20));
+    startHandle.setProperty("fixedX", 0.0);
+    startHandle.setProperty("fixedY", 0.0);
+    QQuickItem endHandle;
+    endHandle.setSize(QSizeF(20, 20));
+    endHandle.setProperty("fixedX", 0.0);
+    endHandle.setProperty("fixedY", 0.0);
+
+    TextSelectionGeometry geometry;
+    geometry.setContentItem(&content);
+    geometry.setStartHandle(&startHandle);
+    geometry.setEndHandle(&endHandle);
+    geometry.setSelectionRange(selectionRange());
+
+    int frame = 0;
+    QBENCHMARK {
+        content.setScrollableOffset(QPointF(0, frame % 500));
+        geometry.updateHandlePositions();
+        ++frame;
+    }
+}
+
+QTEST_MAIN(SelectionPan)
+#include "selectionpan.moc"
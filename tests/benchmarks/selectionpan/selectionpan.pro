@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = selectionpan
+
+include(../../../defaults.pri)
+
+QT += testlib quick
+
+target.path = /opt/tests/sailfish-components-webview/benchmarks
+INSTALLS += target
+
+INCLUDEPATH += ../../../import/controls
+
+HEADERS += ../../../import/controls/textselectiongeometry.h
+SOURCES += selectionpan.cpp \
+           ../../../import/controls/textselectiongeometry.cpp
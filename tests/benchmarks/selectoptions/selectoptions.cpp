@@ -0,0 +1,72 @@
+/****************************************************************************
+**
+** Copyright (c) 2021 Open Mobile Platform LLC.
+**
+****************************************************************************/
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Measures SelectModel with the options of a large select element: setting
+// the options of an embed:select payload and filtering them off the GUI
+// thread.
+
+#include "selectmodel.h"
+
+#include <QtTest>
+
+using SailfishOS::WebView::Pickers::SelectModel;
+
+class SelectOptions : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void setOptions();
+    void asyncFilter();
+
+private:
+    // Options as in an embed:select payload.
+    static QVariantList optionList(int count);
+};
+
+QVariantList SelectOptions::optionList(int count)
+{
+    QVariantList options;
+    for (int i = 0; i < count; ++i) {
+        QVariantMap option;
+        option.insert("label", QStringLiteral("Option %1").arg(i));
+        option.insert("group", i < count / 2 ? QStringLiteral("first") : QStringLiteral("second"));
+        option.insert("index", i);
+        option.insert("selected", false);
+        option.insert("disabled", false);
+        options.append(option);
+    }
+    return options;
+}
+
+void SelectOptions::setOptions()
+{
+    const QVariantList options = optionList(10000);
+    QBENCHMARK {
+        SelectModel model;
+        model.setOptions(options);
+    }
+}
+
+void SelectOptions::asyncFilter()
+{
+    SelectModel model;
+    model.setOptions(optionList(10000));
+
+    QBENCHMARK {
+        model.setFilter(QStringLiteral("option 9"));
+        QTRY_VERIFY(!model.filtering());
+        model.setFilter(QString());
+        QTRY_VERIFY(!model.filtering());
+    }
+}
+
+QTEST_MAIN(SelectOptions)
+#include "selectoptions.moc"
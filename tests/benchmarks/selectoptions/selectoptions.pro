@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = selectoptions
+
+include(../../../defaults.pri)
+
+QT += testlib
+
+target.path = /opt/tests/sailfish-components-webview/benchmarks
+INSTALLS += target
+
+INCLUDEPATH += ../../../import/pickers
+
+HEADERS += ../../../import/pickers/selectmodel.h
+SOURCES += selectoptions.cpp \
+           ../../../import/pickers/selectmodel.cpp
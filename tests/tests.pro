@@ -1,5 +1,5 @@
 TEMPLATE = subdirs
-SUBDIRS += auto
+SUBDIRS += auto benchmarks
 OTHER_FILES += $$PWD/test-definition/tests.xml
 
 xml.path = /opt/tests/sailfish-components-webview/test-definition/
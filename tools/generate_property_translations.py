@@ -1,7 +1,8 @@
 #!/usr/bin/env python3
 #
 # Generates translation strings from gecko property files for lupdate
-# to process
+# to process, or with --table the lookup table from gecko keys to
+# translation ids that the popups plugin is compiled with
 
 import os, os.path, sys, re, dataclasses, functools, argparse
 
@@ -69,25 +70,58 @@ class Translation:
 //% "{self.text}"
 const auto {self.key} = qtTrId("{self.prefix}-{self.key}");"""
 
-def generate(file, url):
+    @property
+    def id(self):
+        return f"{self.prefix}-{self.key}"
+
+    def table_entry(self):
+        return f'    {{ "{self.original_key}", "{self.id}" }},'
+
+def generate(sources):
     print("/* Generated dummy file, do not edit */")
-    for translation in Generator(file, url):
-        print(translation)
+    for file, url in sources:
+        for translation in Generator(file, url):
+            print(translation)
     print("/* End of translations */")
 
+def generate_table(sources):
+    """Prints table entries sorted by gecko key for binary search"""
+    translations = {}
+    for file, url in sources:
+        for translation in Generator(file, url):
+            if translation.original_key in translations:
+                print(f"Duplicate key {translation.original_key} in {url}, "
+                      "using the first one", file=sys.stderr)
+                continue
+            translations[translation.original_key] = translation
+
+    print("/* Generated file, do not edit */")
+    for _, url in sources:
+        print(f"/* Source: {url} */")
+    # Compared with strcmp() at runtime, sort by bytes
+    for key in sorted(translations, key=lambda key: key.encode()):
+        print(translations[key].table_entry())
+
 def main():
     parser = argparse.ArgumentParser(description="""
     URL should be pointing to the exact file and version in version control.
     Use permalink that includes git hash and file path.""")
-    parser.add_argument("file", metavar="FILE", type=argparse.FileType(),
-            help="Property file to read")
+    parser.add_argument("files", metavar="FILE", type=argparse.FileType(), nargs="+",
+            help="Property files to read")
     parser.add_argument("--prefix", "-p", default=DEFAULT_PREFIX,
             help=f"Prefix to use in translation keys [default: {DEFAULT_PREFIX}]")
-    parser.add_argument("--url", default="unknown source",
-            help="Url to source file [default: unknown source]")
+    parser.add_argument("--url", action="append", default=[],
+            help="Url to source file, once for each FILE [default: unknown source]")
+    parser.add_argument("--table", action="store_true",
+            help="Generate the C++ lookup table from gecko keys to translation ids")
     args = parser.parse_args()
     Translation.prefix = args.prefix
-    generate(args.file, args.url)
+    urls = args.url + ["unknown source"] * (len(args.files) - len(args.url))
+    sources = list(zip(args.files, urls))
+    if args.table:
+        generate_table(sources)
+    else:
+        generate(sources)
 
 if __name__ == "__main__":
     main()